@@ -21,6 +21,7 @@
 // Multiply-included file, no traditional include guard.
 #include <string>
 
+#include "base/shared_memory.h"
 #include "base/values.h"
 #include "extensions/common/draggable_region.h"
 #include "content/public/common/common_param_traits.h"
@@ -70,6 +71,15 @@ IPC_MESSAGE_ROUTED3(ShellViewMsg_Object_On_Event,
                     std::string /* event name */,
                     ListValue /* arguments */)
 
+// Like ShellViewMsg_Object_On_Event, but the first argument is a node Buffer
+// wrapping |size| bytes of the shared memory, handed over without a copy.
+IPC_MESSAGE_ROUTED5(ShellViewMsg_Object_On_Buffer_Event,
+                    int /* object id */,
+                    std::string /* event name */,
+                    base::SharedMemoryHandle /* data */,
+                    uint32 /* size */,
+                    ListValue /* more arguments */)
+
 // Request Shell's id for current render_view_host.
 IPC_SYNC_MESSAGE_ROUTED0_1(ShellViewHostMsg_GetShellId,
                            int /* result */)
@@ -94,3 +104,14 @@ IPC_MESSAGE_CONTROL1(ShellViewMsg_Open,
 
 // clear cache on the renderer side
 IPC_MESSAGE_CONTROL0(ShellViewMsg_ClearCache)
+
+// Release as much memory as possible in the renderer. The renderer emits
+// "memoryPurged" on its App object with the usage before and after.
+IPC_MESSAGE_CONTROL2(ShellViewMsg_PurgeMemory,
+                     int /* request id */,
+                     bool /* critical */)
+
+// Emit an event on the App object of the renderer.
+IPC_MESSAGE_CONTROL2(ShellViewMsg_App_Event,
+                     std::string /* event name */,
+                     ListValue /* arguments */)
@@ -20,11 +20,14 @@
 
 #include "content/nw/src/api/app/app.h"
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/logging.h"
 #include "base/message_loop.h"
 #include "base/values.h"
 #include "content/nw/src/api/api_messages.h"
+#include "content/nw/src/browser/capture_page_helper.h"
+#include "content/nw/src/browser/multi_window_capture.h"
 #include "content/nw/src/browser/net_disk_cache_remover.h"
 #include "content/nw/src/nw_package.h"
 #include "content/nw/src/nw_shell.h"
@@ -32,6 +35,7 @@
 #include "content/common/view_messages.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/render_process_host.h"
+#include "googleurl/src/gurl.h"
 
 using content::Shell;
 using content::ShellBrowserContext;
@@ -41,18 +45,27 @@ namespace api {
 
 namespace {
 
-// Get render process host.
-RenderProcessHost* GetRenderProcessHost() {
-  RenderProcessHost* render_process_host = NULL;
-  std::vector<Shell*> windows = Shell::windows();
-  for (size_t i = 0; i < windows.size(); ++i) {
-    if (!windows[i]->is_devtools()) {
-      render_process_host = windows[i]->web_contents()->GetRenderProcessHost();
-      break;
-    }
-  }
+// Tell the renderer that asked for App::ClearCache that it is done, if it is
+// still around.
+void SendClearCacheDone(int render_process_id, int request_id) {
+  RenderProcessHost* rph = RenderProcessHost::FromID(render_process_id);
+  if (!rph)
+    return;
+  base::ListValue args;
+  args.AppendInteger(request_id);
+  rph->Send(new ShellViewMsg_App_Event("clearCacheDone", args));
+}
 
-  return render_process_host;
+void SendCaptureAllWindowsDone(int render_process_id,
+                               int request_id,
+                               const base::ListValue& windows) {
+  RenderProcessHost* rph = RenderProcessHost::FromID(render_process_id);
+  if (!rph)
+    return;
+  base::ListValue args;
+  args.AppendInteger(request_id);
+  args.Append(windows.DeepCopy());
+  rph->Send(new ShellViewMsg_App_Event("captureAllWindowsDone", args));
 }
 
 void GetRenderProcessHosts(std::set<RenderProcessHost*>& rphs) {
@@ -69,7 +82,8 @@ void GetRenderProcessHosts(std::set<RenderProcessHost*>& rphs) {
 }  // namespace
 
 // static
-void App::Call(const std::string& method,
+void App::Call(Shell* shell,
+               const std::string& method,
                const base::ListValue& arguments) {
   if (method == "Quit") {
     Quit();
@@ -77,6 +91,34 @@ void App::Call(const std::string& method,
   } else if (method == "CloseAllWindows") {
     CloseAllWindows();
     return;
+  } else if (method == "ClearCache") {
+    int request_id = 0;
+    arguments.GetInteger(0, &request_id);
+    const base::DictionaryValue* options = NULL;
+    base::DictionaryValue empty_options;
+    if (!arguments.GetDictionary(1, &options))
+      options = &empty_options;
+    ClearCache(shell->web_contents()->GetRenderProcessHost(), request_id,
+               *options);
+    return;
+  } else if (method == "CaptureAllWindows") {
+    int request_id = 0;
+    arguments.GetInteger(0, &request_id);
+    const base::DictionaryValue* options = NULL;
+    base::DictionaryValue empty_options;
+    if (!arguments.GetDictionary(1, &options))
+      options = &empty_options;
+    CaptureAllWindows(shell->web_contents()->GetRenderProcessHost(),
+                      request_id, *options);
+    return;
+  } else if (method == "PurgeMemory") {
+    int request_id = 0;
+    bool critical = false;
+    arguments.GetInteger(0, &request_id);
+    arguments.GetBoolean(1, &critical);
+    PurgeMemory(shell->web_contents()->GetRenderProcessHost(), request_id,
+                critical);
+    return;
   }
   NOTREACHED() << "Calling unknown method " << method << " of App";
 }
@@ -110,8 +152,6 @@ void App::Call(Shell* shell,
     }
 
     return;
-  } else if (method == "ClearCache") {
-    ClearCache(GetRenderProcessHost());
   }
 
   NOTREACHED() << "Calling unknown sync method " << method << " of App";
@@ -168,10 +208,60 @@ void App::EmitOpenEvent(const std::string& path) {
   }
 }
 
-void App::ClearCache(content::RenderProcessHost* render_process_host) {
+void App::ClearCache(content::RenderProcessHost* render_process_host,
+                     int request_id,
+                     const base::DictionaryValue& options) {
   render_process_host->Send(new ShellViewMsg_ClearCache());
-  nw::RemoveHttpDiskCache(render_process_host->GetBrowserContext(),
-                          render_process_host->GetID());
+
+  nw::HttpDiskCacheRemoveOptions remove_options;
+  double time;
+  if (options.GetDouble("since", &time))
+    remove_options.delete_begin = base::Time::FromJsTime(time);
+  if (options.GetDouble("until", &time))
+    remove_options.delete_end = base::Time::FromJsTime(time);
+  const base::ListValue* origins;
+  if (options.GetList("origins", &origins)) {
+    for (size_t i = 0; i < origins->GetSize(); ++i) {
+      std::string origin;
+      if (origins->GetString(i, &origin))
+        remove_options.origins.insert(GURL(origin).GetOrigin());
+    }
+  }
+
+  int render_process_id = render_process_host->GetID();
+  nw::RemoveHttpDiskCache(
+      render_process_host->GetBrowserContext(),
+      render_process_id,
+      remove_options,
+      base::Bind(&SendClearCacheDone, render_process_id, request_id));
+}
+
+// static
+void App::PurgeMemory(content::RenderProcessHost* requester,
+                      int request_id,
+                      bool critical) {
+  std::set<RenderProcessHost*> rphs;
+  GetRenderProcessHosts(rphs);
+  if (requester)
+    rphs.insert(requester);
+
+  for (std::set<RenderProcessHost*>::iterator it = rphs.begin();
+       it != rphs.end(); ++it) {
+    (*it)->Send(new ShellViewMsg_PurgeMemory(
+        *it == requester ? request_id : 0, critical));
+  }
+}
+
+// static
+void App::CaptureAllWindows(content::RenderProcessHost* requester,
+                            int request_id,
+                            const base::DictionaryValue& options) {
+  nw::CapturePageHelper::Options capture_options;
+  if (!nw::CapturePageHelper::ParseOptions(options, &capture_options))
+    return;
+  nw::MultiWindowCapture::Start(
+      capture_options,
+      base::Bind(&SendCaptureAllWindowsDone, requester->GetID(), request_id));
 }
 
 }  // namespace api
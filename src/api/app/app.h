@@ -26,6 +26,7 @@
 #include <string>
 
 namespace base {
+class DictionaryValue;
 class ListValue;
 }
 
@@ -38,7 +39,8 @@ namespace api {
   
 class App {
  public:
-  static void Call(const std::string& method,
+  static void Call(content::Shell* shell,
+                   const std::string& method,
                    const base::ListValue& arguments);
 
   static void Call(content::Shell* shell,
@@ -55,7 +57,30 @@ class App {
   // Post "open" event.
   static void EmitOpenEvent(const std::string& path);
 
-  static void ClearCache(content::RenderProcessHost* render_view_host);
+  // Clear the WebKit memory cache of the renderer and its http disk cache.
+  // |options| may hold "since"/"until" (ms since epoch) and "origins". The
+  // renderer's App object gets a "clearCacheDone" event tagged with
+  // |request_id|.
+  static void ClearCache(content::RenderProcessHost* render_process_host,
+                         int request_id,
+                         const base::DictionaryValue& options);
+
+  // Capture every browser window in parallel. |options| takes the format,
+  // quality, compression and size keys of Window.capturePage. The renderer
+  // of |requester| gets one "captureAllWindowsDone" event with |request_id|
+  // and the list of captures.
+  static void CaptureAllWindows(content::RenderProcessHost* requester,
+                                int request_id,
+                                const base::DictionaryValue& options);
+
+  // Ask every renderer to drop its caches and collect garbage; a |critical|
+  // purge also runs a full V8 GC and clears the font cache. Only the renderer
+  // of |requester| sees |request_id| in its "memoryPurged" event, the others
+  // get 0.
+  static void PurgeMemory(content::RenderProcessHost* requester,
+                          int request_id,
+                          bool critical);
+
  private:
   App();
 
@@ -19,6 +19,9 @@
 //  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 var argv, fullArgv, dataPath;
+var clearCacheRequestId = 0;
+var purgeMemoryRequestId = 0;
+var captureAllWindowsRequestId = 0;
 
 function App() {
 }
@@ -39,8 +42,114 @@ App.prototype.closeAllWindows = function() {
   nw.callStaticMethod('App', 'CloseAllWindows', [ ]);
 }
 
-App.prototype.clearCache = function() {
-  nw.callStaticMethodSync('App', 'ClearCache', [ ]);
+// Clear the memory and http disk caches asynchronously. |options| can limit
+// the disk cache entries to clear:
+//   since, until: Date or milliseconds since epoch, last-used time range
+//   origins: array of origins, e.g. [ 'http://example.com' ]
+// Calls |callback| when done and returns the request id.
+App.prototype.clearCache = function(options, callback) {
+  if (typeof options == 'function') {
+    callback = options;
+    options = undefined;
+  }
+
+  var args = {};
+  if (options) {
+    if (options.since != undefined)
+      args.since = Number(options.since);
+    if (options.until != undefined)
+      args.until = Number(options.until);
+    if (Array.isArray(options.origins))
+      args.origins = options.origins.map(String);
+  }
+
+  var id = ++clearCacheRequestId;
+  if (typeof callback == 'function') {
+    var self = this;
+    this.on('clearCacheDone', function onDone(done_id) {
+      if (done_id != id)
+        return;
+      self.removeListener('clearCacheDone', onDone);
+      callback();
+    });
+  }
+
+  nw.callStaticMethod('App', 'ClearCache', [ id, args ]);
+  return id;
+}
+
+// Drop the caches of every renderer and collect garbage. |level| is
+// 'moderate' (default) or 'critical', which also runs a full GC.
+// |callback|(before, after) gets this renderer's memory usage in bytes.
+App.prototype.purgeMemory = function(level, callback) {
+  if (typeof level == 'function') {
+    callback = level;
+    level = undefined;
+  }
+
+  var id = ++purgeMemoryRequestId;
+  if (typeof callback == 'function') {
+    var self = this;
+    this.on('memoryPurged', function onPurged(done_id, before, after) {
+      if (done_id != id)
+        return;
+      self.removeListener('memoryPurged', onPurged);
+      callback(before, after);
+    });
+  }
+
+  nw.callStaticMethod('App', 'PurgeMemory', [ id, level == 'critical' ]);
+  return id;
+}
+
+// Capture all windows at once; they are encoded in parallel. |options|
+// takes the format, quality, compression, width and height options of
+// Window.capturePage. |callback| gets an array with one
+// { id, url, title, data } per window, where data is a data: URL or null
+// if the window could not be captured. Hidden, throttled and discarded
+// windows do not paint, so they always get null.
+App.prototype.captureAllWindows = function(options, callback) {
+  if (typeof options == 'function') {
+    callback = options;
+    options = undefined;
+  }
+  if (typeof options != 'object' || options === null)
+    options = {};
+
+  var args = {};
+  args.format = options.format;
+  if (args.format != 'jpeg' && args.format != 'png' && args.format != 'webp')
+    args.format = 'jpeg';
+  ['quality', 'compression', 'width', 'height'].forEach(function(key) {
+    if (typeof options[key] == 'number')
+      args[key] = Math.round(options[key]);
+  });
+
+  var id = ++captureAllWindowsRequestId;
+  if (typeof callback == 'function') {
+    var self = this;
+    this.on('captureAllWindowsDone', function onDone(done_id, windows) {
+      if (done_id != id)
+        return;
+      self.removeListener('captureAllWindowsDone', onDone);
+      callback(windows);
+    });
+  }
+
+  nw.callStaticMethod('App', 'CaptureAllWindows', [ id, args ]);
+  return id;
+}
+
+// Set the capacities of this renderer's WebKit memory cache, in bytes:
+//   { minDeadCapacity: ..., maxDeadCapacity: ..., capacity: ... }
+// Missing fields keep their current value.
+App.prototype.setCacheCapacities = function(capacities) {
+  nw.callStaticMethodSync('App', 'SetCacheCapacities', capacities || {});
+}
+
+// Returns the capacities and the live/dead sizes of the WebKit memory cache.
+App.prototype.getCacheUsage = function() {
+  return nw.callStaticMethodSync('App', 'GetCacheUsage', [ ]);
 }
 
 App.prototype.getProxyForURL = function (url) {
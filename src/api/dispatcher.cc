@@ -20,10 +20,12 @@
 
 #include "content/nw/src/api/dispatcher.h"
 
+#include "base/memory/scoped_ptr.h"
 #include "content/nw/src/api/api_messages.h"
 #include "content/public/renderer/render_view.h"
 #include "content/renderer/v8_value_converter_impl.h"
 #include "third_party/node/src/node.h"
+#include "third_party/node/src/node_buffer.h"
 #include "third_party/node/src/req_wrap.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebDocument.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebFrame.h"
@@ -32,6 +34,15 @@
 
 namespace api {
 
+namespace {
+
+// Called by node once the Buffer is garbage collected.
+void FreeSharedMemory(char* data, void* hint) {
+  delete static_cast<base::SharedMemory*>(hint);
+}
+
+}  // namespace
+
 Dispatcher::Dispatcher(content::RenderView* render_view)
     : content::RenderViewObserver(render_view) {
 }
@@ -43,6 +54,7 @@ bool Dispatcher::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(Dispatcher, message)
     IPC_MESSAGE_HANDLER(ShellViewMsg_Object_On_Event, OnEvent)
+    IPC_MESSAGE_HANDLER(ShellViewMsg_Object_On_Buffer_Event, OnBufferEvent)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -88,6 +100,47 @@ void Dispatcher::OnEvent(int object_id,
   node::MakeCallback(objects_registry, "handleEvent", 3, argv);
 }
 
+void Dispatcher::OnBufferEvent(int object_id,
+                               std::string event,
+                               base::SharedMemoryHandle handle,
+                               uint32 size,
+                               const base::ListValue& more_arguments) {
+  scoped_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(handle, true));
+  if (!shared_memory->Map(size)) {
+    NOTREACHED() << "Failed to map the shared memory of event " << event;
+    return;
+  }
+
+  v8::HandleScope scope;
+  v8::Context::Scope context_scope(node::g_context);
+  v8::Handle<v8::Value> val =
+    node::g_context->Global()->Get(v8::String::New("__nwObjectsRegistry"));
+  if (val->IsNull() || val->IsUndefined())
+    return;
+  v8::Handle<v8::Object> objects_registry = val->ToObject();
+
+  // The Buffer takes ownership of the mapping and unmaps it when collected.
+  base::SharedMemory* memory = shared_memory.release();
+  node::Buffer* buffer = node::Buffer::New(
+      static_cast<char*>(memory->memory()), size, FreeSharedMemory, memory);
+
+  content::V8ValueConverterImpl converter;
+  v8::Local<v8::Array> args = v8::Array::New();
+  args->Set(0, buffer->handle_);
+  for (size_t i = 0; i < more_arguments.GetSize(); ++i) {
+    const base::Value* value = NULL;
+    more_arguments.Get(i, &value);
+    args->Set(i + 1, converter.ToV8Value(value, node::g_context));
+  }
+  v8::Handle<v8::Value> argv[] = {
+      v8::Integer::New(object_id), v8::String::New(event.c_str()), args };
+
+  DVLOG(1) << "handleEvent(object_id=" << object_id << ", event=\"" << event
+           << "\", " << size << " bytes)";
+  node::MakeCallback(objects_registry, "handleEvent", 3, argv);
+}
+
 void Dispatcher::ZoomLevelChanged() {
   WebKit::WebView* web_view = render_view()->GetWebView();
   float zoom_level = web_view->zoomLevel();
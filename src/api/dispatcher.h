@@ -22,6 +22,7 @@
 #define CONTENT_NW_SRC_API_DISPATCHER_H_
 
 #include "base/basictypes.h"
+#include "base/shared_memory.h"
 #include "content/public/renderer/render_view_observer.h"
 
 namespace base {
@@ -48,6 +49,11 @@ class Dispatcher : public content::RenderViewObserver {
   void OnEvent(int object_id,
                std::string event,
                const base::ListValue& arguments);
+  void OnBufferEvent(int object_id,
+                     std::string event,
+                     base::SharedMemoryHandle handle,
+                     uint32 size,
+                     const base::ListValue& more_arguments);
 
   DISALLOW_COPY_AND_ASSIGN(Dispatcher);
 };
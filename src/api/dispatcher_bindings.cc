@@ -28,10 +28,12 @@
 #include "chrome/renderer/static_v8_external_string_resource.h"
 #include "content/nw/src/api/api_messages.h"
 #include "content/nw/src/api/bindings_common.h"
+#include "content/nw/src/renderer/shell_render_process_observer.h"
 #include "content/public/renderer/render_view.h"
 #include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/v8_value_converter.h"
 #include "grit/nw_resources.h"
+#include "third_party/WebKit/Source/WebKit/chromium/public/WebCache.h"
 
 using content::RenderView;
 using content::V8ValueConverter;
@@ -388,6 +390,36 @@ v8::Handle<v8::Value> DispatcherBindings::CallStaticMethodSync(
     return v8::String::New(proxy.c_str());
   }
 
+  // The WebKit cache lives in this process, so there is no need to ask the
+  // browser about it.
+  if (type == "App" && method == "SetCacheCapacities") {
+    v8::Handle<v8::Object> options = args[2]->ToObject();
+    const char* keys[] = { "minDeadCapacity", "maxDeadCapacity", "capacity" };
+    int64 capacities[] = { -1, -1, -1 };
+    for (size_t i = 0; i < arraysize(keys); ++i) {
+      v8::Handle<v8::Value> value = options->Get(v8::String::New(keys[i]));
+      if (value->IsNumber())
+        capacities[i] = value->IntegerValue();
+    }
+    content::ShellRenderProcessObserver::SetWebCacheCapacities(
+        capacities[0], capacities[1], capacities[2]);
+    return v8::Undefined();
+  }
+
+  if (type == "App" && method == "GetCacheUsage") {
+    WebKit::WebCache::UsageStats stats;
+    WebKit::WebCache::getUsageStats(&stats);
+    v8::Handle<v8::Object> usage = v8::Object::New();
+    usage->Set(v8::String::New("minDeadCapacity"),
+               v8::Number::New(stats.minDeadCapacity));
+    usage->Set(v8::String::New("maxDeadCapacity"),
+               v8::Number::New(stats.maxDeadCapacity));
+    usage->Set(v8::String::New("capacity"), v8::Number::New(stats.capacity));
+    usage->Set(v8::String::New("liveSize"), v8::Number::New(stats.liveSize));
+    usage->Set(v8::String::New("deadSize"), v8::Number::New(stats.deadSize));
+    return usage;
+  }
+
   scoped_ptr<base::Value> value_args(
       converter->FromV8Value(args[2], v8::Context::GetCurrent()));
   if (!value_args.get() ||
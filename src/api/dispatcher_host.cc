@@ -159,7 +159,9 @@ void DispatcherHost::OnCallStaticMethod(
     api::Shell::Call(method, arguments);
     return;
   } else if (type == "App") {
-    api::App::Call(method, arguments);
+    content::Shell* shell =
+        content::Shell::FromRenderViewHost(render_view_host());
+    api::App::Call(shell, method, arguments);
     return;
   }
 
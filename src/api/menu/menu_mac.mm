@@ -61,6 +61,10 @@ void Menu::Remove(MenuItem* menu_item, int pos) {
 }
 
 void Menu::Popup(int x, int y, content::Shell* shell) {
+  // A headless window has no NSWindow to pop up over.
+  if (shell->window()->IsHeadless())
+    return;
+
   // Fake out a context menu event for our menu
   NSWindow* window =
        static_cast<nw::NativeWindowCocoa*>(shell->window())->window();
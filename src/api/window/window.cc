@@ -20,14 +20,102 @@
 
 #include "content/nw/src/api/window/window.h"
 
+#include "base/bind.h"
+#include "base/shared_memory.h"
 #include "base/values.h"
+#include "content/nw/src/api/api_messages.h"
 #include "content/nw/src/api/dispatcher_host.h"
 #include "content/nw/src/api/menu/menu.h"
+#include "content/nw/src/browser/first_paint_tracker.h"
 #include "content/nw/src/browser/native_window.h"
+#include "content/nw/src/browser/window_discarder.h"
+#include "content/nw/src/browser/window_throttler.h"
 #include "content/nw/src/nw_shell.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/web_contents.h"
+
+#if defined(ENABLE_PRINTING)
+#include "content/nw/src/browser/printing/print_job_manager.h"
+#include "content/nw/src/browser/printing/print_preview_message_handler.h"
+#include "content/nw/src/browser/printing/print_view_manager.h"
+#include "content/nw/src/shell_content_browser_client.h"
+#include "content/public/common/content_client.h"
+#endif
 
 namespace api {
 
+namespace {
+
+const char kPrintToPDFDoneEvent[] = "printtopdfdone";
+
+// Emits "printtopdfdone" with (data, info): data is a Buffer, the path of
+// the written file, or null on error; info holds requestId, pages, elapsed
+// (ms), timing (ms per phase, if known) and error.
+void SendPrintToPDFResult(content::Shell* shell,
+                          int request_id,
+                          const std::string& error,
+                          int page_count,
+                          double elapsed,
+                          const base::DictionaryValue* timing,
+                          const base::FilePath& path,
+                          base::SharedMemory* data,
+                          uint32 data_size) {
+  if (shell->id() < 0)
+    return;
+
+  base::DictionaryValue info;
+  info.SetInteger("requestId", request_id);
+  info.SetInteger("pages", page_count);
+  info.SetDouble("elapsed", elapsed);
+  if (timing)
+    info.Set("timing", timing->DeepCopy());
+  if (!error.empty())
+    info.SetString("error", error);
+
+  content::RenderViewHost* render_view_host =
+      shell->web_contents()->GetRenderViewHost();
+  if (error.empty() && data) {
+    base::SharedMemoryHandle handle;
+    if (data->ShareToProcess(render_view_host->GetProcess()->GetHandle(),
+                             &handle)) {
+      base::ListValue extra_args;
+      extra_args.Append(info.DeepCopy());
+      render_view_host->Send(new ShellViewMsg_Object_On_Buffer_Event(
+          render_view_host->GetRoutingID(), shell->id(), kPrintToPDFDoneEvent,
+          handle, data_size, extra_args));
+      return;
+    }
+    info.SetString("error", "Failed to share the PDF with the renderer");
+  }
+
+  base::ListValue args;
+  if (info.HasKey("error"))
+    args.Append(base::Value::CreateNullValue());
+  else
+    args.AppendString(path.AsUTF8Unsafe());
+  args.Append(info.DeepCopy());
+  shell->SendEvent(kPrintToPDFDoneEvent, args);
+}
+
+#if defined(ENABLE_PRINTING)
+void OnPrintToPDFDone(content::Shell* shell,
+                      int request_id,
+                      printing::PrintPreviewMessageHandler::Result* result) {
+  base::DictionaryValue timing;
+  timing.SetDouble("layout", result->layout_time.InMillisecondsF());
+  timing.SetDouble("render", result->render_time.InMillisecondsF());
+  timing.SetDouble("finalize", result->finalize_time.InMillisecondsF());
+  timing.SetDouble("ipc", result->ipc_time.InMillisecondsF());
+  timing.SetDouble("write", result->write_time.InMillisecondsF());
+  SendPrintToPDFResult(shell, request_id, result->error, result->page_count,
+                       result->elapsed.InMillisecondsF(), &timing,
+                       result->path, result->data.get(), result->data_size);
+}
+#endif
+
+}  // namespace
+
 Window::Window(int id,
                DispatcherHost* dispatcher_host,
                const base::DictionaryValue& option)
@@ -50,6 +138,9 @@ Window::~Window() {
 void Window::Call(const std::string& method,
                   const base::ListValue& arguments) {
   if (method == "Show") {
+    shell_->window_discarder()->SetHidden(false);
+    shell_->window_throttler()->SetHidden(false);
+    shell_->first_paint_tracker()->WindowShown();
     shell_->window()->Show();
   } else if (method == "Close") {
     bool force = false;
@@ -57,7 +148,10 @@ void Window::Call(const std::string& method,
     shell_->set_force_close(force);
     shell_->window()->Close();
   } else if (method == "Hide") {
+    shell_->first_paint_tracker()->WindowHidden();
     shell_->window()->Hide();
+    shell_->window_throttler()->SetHidden(true);
+    shell_->window_discarder()->SetHidden(true);
   } else if (method == "Maximize") {
     shell_->window()->Maximize();
   } else if (method == "Unmaximize") {
@@ -107,6 +201,20 @@ void Window::Call(const std::string& method,
     bool top;
     if (arguments.GetBoolean(0, &top))
       shell_->window()->SetAlwaysOnTop(top);
+  } else if (method == "SetMaxFps") {
+    int fps;
+    if (arguments.GetInteger(0, &fps))
+      shell_->window_throttler()->SetMaxFps(fps);
+  } else if (method == "SetBackgroundThrottling") {
+    bool enabled;
+    if (arguments.GetBoolean(0, &enabled))
+      shell_->window_throttler()->SetBackgroundThrottling(enabled);
+  } else if (method == "SetDiscardTimeout") {
+    int seconds;
+    if (arguments.GetInteger(0, &seconds))
+      shell_->window_discarder()->SetTimeout(seconds);
+  } else if (method == "Discard") {
+    shell_->window_discarder()->Discard();
   } else if (method == "MoveTo") {
     int x, y;
     if (arguments.GetInteger(0, &x) &&
@@ -125,9 +233,67 @@ void Window::Call(const std::string& method,
     if (arguments.GetInteger(0, &type))
       shell_->Reload(static_cast<content::Shell::ReloadType>(type));
   } else if (method == "CapturePage") {
-    std::string image_format_str;
-    if (arguments.GetString(0, &image_format_str))
-      shell_->window()->CapturePage(image_format_str);
+    const base::DictionaryValue* options = NULL;
+    if (arguments.GetDictionary(0, &options))
+      shell_->window()->CapturePage(*options);
+  } else if (method == "StartScreencast") {
+    const base::DictionaryValue* options = NULL;
+    if (arguments.GetDictionary(0, &options))
+      shell_->window()->StartScreencast(*options);
+  } else if (method == "StopScreencast") {
+    shell_->window()->StopScreencast();
+  } else if (method == "AckScreencastFrame") {
+    int sequence;
+    if (arguments.GetInteger(0, &sequence))
+      shell_->window()->AckScreencastFrame(sequence);
+  } else if (method == "Print") {
+#if defined(ENABLE_PRINTING)
+    const base::DictionaryValue* options = NULL;
+    if (!arguments.GetDictionary(0, &options))
+      return;
+    printing::PrintViewManager* print_view_manager =
+        printing::PrintViewManager::FromWebContents(shell_->web_contents());
+    int priority;
+    if (options->GetInteger("priority", &priority) &&
+        priority >= printing::PrintJobManager::PRIORITY_LOW &&
+        priority <= printing::PrintJobManager::PRIORITY_HIGH) {
+      print_view_manager->set_print_priority(
+          static_cast<printing::PrintJobManager::Priority>(priority));
+    }
+    print_view_manager->PrintNow();
+#endif
+  } else if (method == "CancelPrintJob") {
+#if defined(ENABLE_PRINTING)
+    int id;
+    if (arguments.GetInteger(0, &id)) {
+      content::ShellContentBrowserClient* browser_client =
+          static_cast<content::ShellContentBrowserClient*>(
+              content::GetContentClient()->browser());
+      content::RenderViewHost* render_view_host =
+          shell_->web_contents()->GetRenderViewHost();
+      browser_client->print_job_manager()->CancelPrintJob(
+          id, render_view_host->GetProcess()->GetID(),
+          render_view_host->GetRoutingID());
+    }
+#endif
+  } else if (method == "PrintToPDF") {
+    int request_id;
+    const base::DictionaryValue* options = NULL;
+    if (!arguments.GetInteger(0, &request_id) ||
+        !arguments.GetDictionary(1, &options))
+      return;
+    std::string path_utf8;
+    options->GetString("path", &path_utf8);
+    base::FilePath path = base::FilePath::FromUTF8Unsafe(path_utf8);
+#if defined(ENABLE_PRINTING)
+    printing::PrintPreviewMessageHandler::FromWebContents(
+        shell_->web_contents())->PrintToPDF(
+            *options, path,
+            base::Bind(&OnPrintToPDFDone, shell_, request_id));
+#else
+    SendPrintToPDFResult(shell_, request_id, "Printing is not supported",
+                         0, 0, NULL, path, NULL, 0);
+#endif
   } else {
     NOTREACHED() << "Invalid call to Window method:" << method
                  << " arguments:" << arguments;
@@ -141,6 +307,12 @@ void Window::CallSync(const std::string& method,
     result->AppendBoolean(shell_->window()->IsFullscreen());
   } else if (method == "IsKioskMode") {
     result->AppendBoolean(shell_->window()->IsKiosk());
+  } else if (method == "IsDiscarded") {
+    result->AppendBoolean(shell_->window_discarder()->is_discarded());
+  } else if (method == "GetPaintTiming") {
+    base::DictionaryValue* timing = new base::DictionaryValue;
+    shell_->first_paint_tracker()->GetTiming(timing);
+    result->Append(timing);
   } else if (method == "GetSize") {
     gfx::Size size = shell_->window()->GetSize();
     result->AppendInteger(size.width());
@@ -296,6 +296,44 @@ Window.prototype.setAlwaysOnTop = function(flag) {
   CallObjectMethod(this, 'SetAlwaysOnTop', [ Boolean(flag) ]);
 }
 
+// Run requestAnimationFrame callbacks at most |fps| times a second, 0 to
+// remove the cap. Only requestAnimationFrame of the top frame is capped,
+// by wrapping it once a cap is first set; timers, CSS animations, video
+// and painting keep their own rate.
+Window.prototype.setMaxFps = function(fps) {
+  fps = Math.max(0, Math.round(Number(fps) || 0));
+  CallObjectMethod(this, 'SetMaxFps', [ fps ]);
+}
+
+// While enabled, the page is throttled like a background tab whenever the
+// window is hidden, minimized or occluded: no painting, no animation
+// frames and timers at most once a second. Occlusion is only detected on
+// Linux.
+Window.prototype.setBackgroundThrottling = function(flag) {
+  CallObjectMethod(this, 'SetBackgroundThrottling', [ Boolean(flag) ]);
+}
+
+// Discard the page once the window has been hidden for |seconds|, 0 to
+// never discard. The page gets a 'discard' event before it is dropped and
+// a 'revive' event after show() has loaded it again.
+Window.prototype.setDiscardTimeout = function(seconds) {
+  seconds = Math.max(0, Math.round(Number(seconds) || 0));
+  CallObjectMethod(this, 'SetDiscardTimeout', [ seconds ]);
+}
+
+// Discard the page of a hidden window now.
+Window.prototype.discard = function() {
+  CallObjectMethod(this, 'Discard', []);
+}
+
+Window.prototype.__defineGetter__('isDiscarded', function() {
+  return CallObjectMethodSync(this, 'IsDiscarded', [])[0];
+});
+
+Window.prototype.__defineGetter__('paintTiming', function() {
+  return CallObjectMethodSync(this, 'GetPaintTiming', [])[0];
+});
+
 Window.prototype.requestAttention = function(flash) {
   flash = Boolean(flash);
   CallObjectMethod(this, 'RequestAttention', [ flash ]);
@@ -327,18 +365,255 @@ Window.prototype.reloadDev = function() {
   this.reload(3);
 }
 
-Window.prototype.capturePage = function(callback, image_format) {
-  if (image_format != 'jpeg' && image_format != 'png') {
-    image_format = 'jpeg';
+var nextCapturePageRequestId = 0;
+
+Window.prototype.capturePage = function(callback, options) {
+  // Accept the old capturePage(callback, 'png') form as well as an options
+  // object: { format: 'jpeg'|'png'|'webp', quality: 0-100,
+  //           compression: 0-9, datatype: 'datauri'|'buffer'|'file',
+  //           path: '...', width: pixels, height: pixels,
+  //           fullPage: bool, tiled: bool, tileHeight: pixels }.
+  // width and height scale the capture down (or up) to fit, keeping its
+  // aspect ratio; they are ignored with fullPage.
+  // With fullPage the whole scrollable page is captured as a PNG. With
+  // tiled as well, callback(data, tile) is called once per tile instead,
+  // and tile.last is set on the final one.
+  // If the capture fails, callback(null, err) is called, or for a tiled
+  // capture callback(null, tile) with tile.last set and tile.error giving
+  // the reason.
+  if (typeof options == 'string' || typeof options == 'undefined')
+    options = { format: options };
+  if (typeof options != 'object' || options === null)
+    options = {};
+
+  var params = {};
+  params.format = options.format;
+  if (params.format != 'jpeg' && params.format != 'png' &&
+      params.format != 'webp')
+    params.format = 'jpeg';
+  if (typeof options.quality == 'number')
+    params.quality = Math.round(options.quality);
+  if (typeof options.compression == 'number')
+    params.compression = Math.round(options.compression);
+  if (typeof options.width == 'number')
+    params.width = Math.round(options.width);
+  if (typeof options.height == 'number')
+    params.height = Math.round(options.height);
+  params.datatype = options.datatype;
+  if (params.datatype == 'file') {
+    if (typeof options.path != 'string' || options.path == '')
+      throw new TypeError("capturePage: 'file' needs a path");
+    params.path = options.path;
+  } else if (params.datatype != 'buffer') {
+    params.datatype = 'datauri';
+  }
+
+  if (options.fullPage) {
+    params.fullPage = true;
+    params.tiled = !!options.tiled;
+    if (typeof options.tileHeight == 'number')
+      params.tileHeight = Math.round(options.tileHeight);
   }
 
+  // Captures finish in the order they are encoded, not the order they were
+  // asked for, so each one only listens for the replies carrying its id.
+  var requestId = ++nextCapturePageRequestId;
+  params.requestId = requestId;
   if (typeof callback == 'function') {
-    this.once('capturepagedone', function(imgdata) {
-      callback(imgdata);
+    var self = this;
+    if (params.tiled) {
+      var onTile = function(imgdata, tile) {
+        if (tile.requestId != requestId)
+          return;
+        if (tile.last)
+          self.removeListener('capturepagetile', onTile);
+        delete tile.requestId;
+        callback(imgdata, tile);
+      };
+      this.on('capturepagetile', onTile);
+    } else {
+      var onDone = function(imgdata, info) {
+        if (info.requestId != requestId)
+          return;
+        self.removeListener('capturepagedone', onDone);
+        if (info.error)
+          callback(null, new Error(info.error));
+        else
+          callback(imgdata);
+      };
+      this.on('capturepagedone', onDone);
+    }
+  }
+
+  CallObjectMethod(this, 'CapturePage', [params]);
+}
+
+Window.prototype.startScreencast = function(options, callback) {
+  // Frames come as { sequence, keyframe, width, height, timestamp, rects },
+  // each rect being { x, y, width, height, data } with data a data: URL of
+  // the changed area. options takes the capturePage format, quality and
+  // compression plus maxFps, maxPendingFrames and keyframeInterval (ms).
+  if (typeof options == 'function') {
+    callback = options;
+    options = {};
+  }
+  if (typeof options != 'object' || options === null)
+    options = {};
+
+  var params = {};
+  params.format = options.format == 'png' ? 'png' : 'jpeg';
+  ['quality', 'compression', 'maxFps', 'maxPendingFrames',
+   'keyframeInterval'].forEach(function(key) {
+    if (typeof options[key] == 'number')
+      params[key] = Math.round(options[key]);
+  });
+
+  this.stopScreencast();
+  var self = this;
+  var listener = function(frame) {
+    try {
+      if (typeof callback == 'function')
+        callback(frame);
+    } finally {
+      // Let the browser grab the next frame.
+      CallObjectMethod(self, 'AckScreencastFrame', [frame.sequence]);
+    }
+  };
+  v8_util.setHiddenValue(this, 'screencastListener', listener);
+  this.on('screencastframe', listener);
+
+  CallObjectMethod(this, 'StartScreencast', [params]);
+}
+
+Window.prototype.stopScreencast = function() {
+  var listener = v8_util.getHiddenValue(this, 'screencastListener');
+  if (!listener)
+    return;
+  CallObjectMethod(this, 'StopScreencast', []);
+  this.removeListener('screencastframe', listener);
+  v8_util.setHiddenValue(this, 'screencastListener', null);
+}
+
+// Values of printing::PrintJobManager::Priority.
+var kPrintPriorities = {
+  'low': 0,
+  'normal': 1,
+  'high': 2
+};
+
+Window.prototype.print = function(options) {
+  // options: { priority: 'low'|'normal'|'high' }. The priority also applies
+  // to later print jobs of the window, window.print() included. Jobs to the
+  // same printer run one at a time, higher priorities first.
+  // Each job reports through 'printjob' events with { id, state, priority,
+  // printer, pagesPrinted, pageCount }, state being 'queued', 'printing',
+  // 'done', 'failed' or 'canceled'.
+  if (typeof options != 'object' || options === null)
+    options = {};
+
+  var params = {};
+  if (options.priority !== undefined) {
+    if (!kPrintPriorities.hasOwnProperty(options.priority))
+      throw new TypeError("print: unknown priority '" + options.priority +
+                          "'");
+    params.priority = kPrintPriorities[options.priority];
+  }
+  CallObjectMethod(this, 'Print', [params]);
+}
+
+Window.prototype.cancelPrintJob = function(id) {
+  CallObjectMethod(this, 'CancelPrintJob', [Number(id)]);
+}
+
+// Paper sizes in microns, as printToPDF takes them.
+var kPdfPageSizes = {
+  'A3': { width: 297000, height: 420000 },
+  'A4': { width: 210000, height: 297000 },
+  'Letter': { width: 215900, height: 279400 },
+  'Legal': { width: 215900, height: 355600 },
+  'Tabloid': { width: 279400, height: 431800 }
+};
+
+// Values of printing::MarginType.
+var kPdfMarginsTypes = {
+  'default': 0,
+  'none': 1,
+  'minimum': 2,
+  'custom': 3
+};
+
+var nextPrintToPDFRequestId = 0;
+
+Window.prototype.printToPDF = function(options, callback) {
+  // options: { path: '...', landscape: bool, printBackground: bool,
+  //            pageSize: 'A3'|'A4'|'Letter'|'Legal'|'Tabloid' or
+  //                      { width, height } in microns,
+  //            marginsType: 'default'|'none'|'minimum'|'custom',
+  //            margins: { top, bottom, left, right } in points,
+  //            headerFooter: bool, title: '...', url: '...',
+  //            pageRanges: [ { from, to } ] counted from 1 }.
+  // callback(err, data, info) gets a Buffer of the PDF, or its path when
+  // options.path is set; info is { pages, elapsed, timing } with times in
+  // ms, timing being { layout, render, finalize, ipc, write }.
+  if (typeof options == 'function') {
+    callback = options;
+    options = {};
+  }
+  if (typeof options != 'object' || options === null)
+    options = {};
+
+  var params = {};
+  ['landscape', 'printBackground', 'headerFooter'].forEach(function(key) {
+    if (options[key] !== undefined)
+      params[key] = !!options[key];
+  });
+  ['path', 'title', 'url'].forEach(function(key) {
+    if (typeof options[key] == 'string')
+      params[key] = options[key];
+  });
+
+  var pageSize = options.pageSize;
+  if (typeof pageSize == 'string') {
+    if (!kPdfPageSizes.hasOwnProperty(pageSize))
+      throw new TypeError("printToPDF: unknown pageSize '" + pageSize + "'");
+    pageSize = kPdfPageSizes[pageSize];
+  }
+  if (typeof pageSize == 'object' && pageSize !== null)
+    params.pageSize = { width: Math.round(pageSize.width),
+                        height: Math.round(pageSize.height) };
+
+  if (options.marginsType !== undefined) {
+    if (!kPdfMarginsTypes.hasOwnProperty(options.marginsType))
+      throw new TypeError("printToPDF: unknown marginsType '" +
+                          options.marginsType + "'");
+    params.marginsType = kPdfMarginsTypes[options.marginsType];
+  }
+  if (typeof options.margins == 'object' && options.margins !== null)
+    params.margins = options.margins;
+
+  if (Array.isArray(options.pageRanges)) {
+    params.pageRanges = options.pageRanges.map(function(range) {
+      return { from: Math.round(range.from), to: Math.round(range.to) };
     });
   }
 
-  CallObjectMethod(this, 'CapturePage', [image_format]);
+  var requestId = ++nextPrintToPDFRequestId;
+  var self = this;
+  var listener = function(data, info) {
+    if (info.requestId != requestId)
+      return;
+    self.removeListener('printtopdfdone', listener);
+    delete info.requestId;
+    if (typeof callback != 'function')
+      return;
+    if (info.error)
+      callback(new Error(info.error), null, info);
+    else
+      callback(null, data, info);
+  };
+  this.on('printtopdfdone', listener);
+
+  CallObjectMethod(this, 'PrintToPDF', [requestId, params]);
 }
 
 }  // function Window.init
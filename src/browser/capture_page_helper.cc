@@ -20,22 +20,39 @@
 
 #include "content/nw/src/browser/capture_page_helper.h"
 
+#include <stdlib.h>
+
+#include <algorithm>
 #include <vector>
 
 #include "base/base64.h"
 #include "base/bind.h"
+#include "base/file_util.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/shared_memory.h"
 #include "base/stl_util.h"
 #include "base/stringprintf.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "base/threading/worker_pool.h"
+#include "base/values.h"
 #include "content/nw/src/api/api_messages.h"
+#include "content/nw/src/browser/image_resizer.h"
+#include "content/nw/src/browser/parallel_png_encoder.h"
 #include "content/nw/src/nw_shell.h"
 #include "content/nw/src/renderer/common/render_messages.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/render_widget_host_view.h"
 #include "content/public/browser/web_contents.h"
 #include "skia/ext/platform_canvas.h"
+#include "third_party/libwebp/webp/encode.h"
 #include "ui/gfx/codec/jpeg_codec.h"
-#include "ui/gfx/codec/png_codec.h"
 #include "ui/gfx/rect.h"
+#include "ui/gfx/size.h"
+
+using content::BrowserThread;
 
 namespace nw {
 
@@ -43,37 +60,367 @@ namespace capture_page_helper_constants {
 
 const char kFormatValueJpeg[] = "jpeg";
 const char kFormatValuePng[] = "png";
+const char kFormatValueWebp[] = "webp";
 const char kMimeTypeJpeg[] = "image/jpeg";
 const char kMimeTypePng[] = "image/png";
+const char kMimeTypeWebp[] = "image/webp";
+
+const char kDataTypeValueDataUrl[] = "datauri";
+const char kDataTypeValueBuffer[] = "buffer";
+const char kDataTypeValueFile[] = "file";
+
+const char kFormatKey[] = "format";
+const char kQualityKey[] = "quality";
+const char kCompressionKey[] = "compression";
+const char kDataTypeKey[] = "datatype";
+const char kPathKey[] = "path";
+const char kFullPageKey[] = "fullPage";
+const char kTiledKey[] = "tiled";
+const char kTileHeightKey[] = "tileHeight";
+const char kWidthKey[] = "width";
+const char kHeightKey[] = "height";
+const char kRequestIdKey[] = "requestId";
 
 const int kDefaultQuality = 90;
+const int kDefaultCompressionLevel = 6;
+const int kDefaultTileHeight = 1024;
 
 }; // namespace capture_page_helper_constants
 
 namespace keys = nw::capture_page_helper_constants;
 
+struct CapturePageHelper::Result {
+  Result() : size(0), succeeded(false) {}
+
+  std::string data_url;
+  scoped_ptr<base::SharedMemory> shared_memory;
+  uint32 size;
+  bool succeeded;
+};
+
+namespace {
+
+// Hands |data| back in the form asked for by |options|. Runs on the worker
+// pool.
+void PackageEncodedData(const CapturePageHelper::Options& options,
+                        const std::string& mime_type,
+                        const std::vector<unsigned char>& data,
+                        CapturePageHelper::Result* result) {
+  switch (options.data_type) {
+    case CapturePageHelper::DATA_TYPE_DATA_URL:
+      result->data_url = CapturePageHelper::ToDataUrl(mime_type, data);
+      result->succeeded = true;
+      break;
+    case CapturePageHelper::DATA_TYPE_BUFFER: {
+      scoped_ptr<base::SharedMemory> shared_memory(new base::SharedMemory);
+      if (!shared_memory->CreateAndMapAnonymous(data.size())) {
+        VLOG(1) << "Allocating " << data.size() << " bytes of shared memory"
+                << " failed.";
+        return;
+      }
+      memcpy(shared_memory->memory(), vector_as_array(&data), data.size());
+      result->shared_memory.reset(shared_memory.release());
+      result->size = data.size();
+      result->succeeded = true;
+      break;
+    }
+    case CapturePageHelper::DATA_TYPE_FILE: {
+      int written = file_util::WriteFile(
+          options.path, reinterpret_cast<const char*>(vector_as_array(&data)),
+          data.size());
+      if (written != static_cast<int>(data.size())) {
+        VLOG(1) << "Writing " << options.path.value() << " failed.";
+        return;
+      }
+      result->succeeded = true;
+      break;
+    }
+  }
+}
+
+// Runs on the worker pool. Leaves |result->succeeded| false on failure.
+void EncodeBitmapOnWorker(const CapturePageHelper::Options& options,
+                          const SkBitmap* bitmap,
+                          CapturePageHelper::Result* result) {
+  std::vector<unsigned char> data;
+  std::string mime_type;
+  if (!CapturePageHelper::EncodeImage(
+          options, CapturePageHelper::ScaleBitmap(options, *bitmap),
+          &data, &mime_type)) {
+    VLOG(1) << "Encoding failed.";
+    return;
+  }
+
+  PackageEncodedData(options, mime_type, data, result);
+}
+
+}  // namespace
+
+// State of one full page capture. Tiles are encoded on a sequenced task
+// runner of the blocking pool so they are processed in page order while the
+// UI thread keeps receiving the next ones.
+class CapturePageHelper::FullPageCapture
+    : public base::RefCountedThreadSafe<FullPageCapture> {
+ public:
+  explicit FullPageCapture(const Options& options)
+      : options_(options),
+        failed_(false),
+        tiles_received_(0) {
+    base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+    task_runner_ = pool->GetSequencedTaskRunnerWithShutdownBehavior(
+        pool->GetSequenceToken(),
+        base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  }
+
+  const Options& options() const { return options_; }
+  base::SequencedTaskRunner* task_runner() const { return task_runner_; }
+
+  // Returns the index of the next tile and counts it.
+  int NextTileIndex() { return tiles_received_++; }
+
+  // Whether appending a tile failed. Only read it on the UI thread in the
+  // reply to a task of |task_runner_|.
+  bool failed() const { return failed_; }
+
+  // Feeds |tile| into the stitched PNG. Runs on |task_runner_|.
+  void AppendTile(const SkBitmap* tile, const gfx::Size& page_size) {
+    if (failed_)
+      return;
+    bool first = encoder_.rows_written() == 0;
+    if (first && !encoder_.Begin(page_size.width(), page_size.height(),
+                                 options_.compression_level)) {
+      failed_ = true;
+      return;
+    }
+    if (!encoder_.AppendRows(*tile)) {
+      failed_ = true;
+      return;
+    }
+    encoder_.TakeOutput(&encoded_);
+    if (options_.data_type == DATA_TYPE_FILE)
+      FlushToFile(first);
+  }
+
+  // Ends the stitched PNG and packages it into |result|. Runs on
+  // |task_runner_|.
+  void Finish(Result* result) {
+    if (failed_ || !encoder_.Finish())
+      return;
+    encoder_.TakeOutput(&encoded_);
+    if (options_.data_type == DATA_TYPE_FILE) {
+      FlushToFile(false);
+      result->succeeded = !failed_;
+      return;
+    }
+    PackageEncodedData(options_, keys::kMimeTypePng, encoded_, result);
+    encoded_.clear();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<FullPageCapture>;
+  ~FullPageCapture() {}
+
+  // Moves what is encoded so far to the file, so only the bytes of one tile
+  // are ever held in memory.
+  void FlushToFile(bool create) {
+    const char* data = reinterpret_cast<const char*>(vector_as_array(&encoded_));
+    int size = static_cast<int>(encoded_.size());
+    int written = create ?
+        file_util::WriteFile(options_.path, data, size) :
+        file_util::AppendToFile(options_.path, data, size);
+    if (written != size) {
+      VLOG(1) << "Writing " << options_.path.value() << " failed.";
+      failed_ = true;
+    }
+    encoded_.clear();
+  }
+
+  Options options_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  // Only used on |task_runner_|.
+  PNGStreamEncoder encoder_;
+  std::vector<unsigned char> encoded_;
+  bool failed_;
+
+  // Only used on the UI thread.
+  int tiles_received_;
+
+  DISALLOW_COPY_AND_ASSIGN(FullPageCapture);
+};
+
+CapturePageHelper::Options::Options()
+    : format(FORMAT_JPEG),
+      quality(keys::kDefaultQuality),
+      compression_level(keys::kDefaultCompressionLevel),
+      data_type(DATA_TYPE_DATA_URL),
+      full_page(false),
+      tiled(false),
+      tile_height(keys::kDefaultTileHeight),
+      request_id(0) {
+}
+
 // static
 scoped_refptr<CapturePageHelper> CapturePageHelper::Create(
     content::Shell* shell) {
   return make_scoped_refptr(new CapturePageHelper(shell));
 }
 
+// static
+bool CapturePageHelper::ParseOptions(const base::DictionaryValue& value,
+                                     Options* options) {
+  std::string image_format_str;
+  if (value.GetString(keys::kFormatKey, &image_format_str)) {
+    if (image_format_str == keys::kFormatValueJpeg) {
+      options->format = FORMAT_JPEG;
+    } else if (image_format_str == keys::kFormatValuePng) {
+      options->format = FORMAT_PNG;
+    } else if (image_format_str == keys::kFormatValueWebp) {
+      options->format = FORMAT_WEBP;
+    } else {
+      NOTREACHED() << "Invalid image format";
+      return false;
+    }
+  }
+  if (value.GetInteger(keys::kQualityKey, &options->quality))
+    options->quality = std::max(0, std::min(options->quality, 100));
+  if (value.GetInteger(keys::kCompressionKey, &options->compression_level)) {
+    options->compression_level =
+        std::max(0, std::min(options->compression_level, 9));
+  }
+  int max_width = 0;
+  int max_height = 0;
+  value.GetInteger(keys::kWidthKey, &max_width);
+  value.GetInteger(keys::kHeightKey, &max_height);
+  options->max_size.SetSize(std::max(max_width, 0), std::max(max_height, 0));
+  std::string data_type_str;
+  if (value.GetString(keys::kDataTypeKey, &data_type_str)) {
+    if (data_type_str == keys::kDataTypeValueBuffer) {
+      options->data_type = DATA_TYPE_BUFFER;
+    } else if (data_type_str == keys::kDataTypeValueFile) {
+      std::string path;
+      if (!value.GetString(keys::kPathKey, &path) || path.empty()) {
+        NOTREACHED() << "No path given for capturing to a file";
+        return false;
+      }
+      options->data_type = DATA_TYPE_FILE;
+      options->path = base::FilePath::FromUTF8Unsafe(path);
+    } else if (data_type_str != keys::kDataTypeValueDataUrl) {
+      NOTREACHED() << "Invalid data type";
+      return false;
+    }
+  }
+  return true;
+}
+
+// static
+SkBitmap CapturePageHelper::ScaleBitmap(const Options& options,
+                                        const SkBitmap& bitmap) {
+  if (options.max_size.width() <= 0 && options.max_size.height() <= 0)
+    return bitmap;
+  return ResizeBitmap(bitmap, FitSizeInBounds(
+      gfx::Size(bitmap.width(), bitmap.height()), options.max_size));
+}
+
+// static
+bool CapturePageHelper::EncodeImage(const Options& options,
+                                    const SkBitmap& bitmap,
+                                    std::vector<unsigned char>* data,
+                                    std::string* mime_type) {
+  SkAutoLockPixels bitmap_lock(bitmap);
+  bool encoded = false;
+  switch (options.format) {
+    case FORMAT_JPEG:
+      encoded = gfx::JPEGCodec::Encode(
+          reinterpret_cast<unsigned char*>(bitmap.getAddr32(0, 0)),
+          gfx::JPEGCodec::FORMAT_SkBitmap,
+          bitmap.width(),
+          bitmap.height(),
+          static_cast<int>(bitmap.rowBytes()),
+          options.quality,
+          data);
+      *mime_type = keys::kMimeTypeJpeg;
+      break;
+    case FORMAT_PNG:
+      // Transparency is discarded.
+      encoded = EncodePNGInStripes(bitmap, options.compression_level, data);
+      *mime_type = keys::kMimeTypePng;
+      break;
+    case FORMAT_WEBP: {
+      // Skia keeps its pixels in the platform's native byte order.
+      uint8_t* output = NULL;
+      size_t output_size =
+#if SK_R32_SHIFT == 16
+          WebPEncodeBGRA(
+#else
+          WebPEncodeRGBA(
+#endif
+              reinterpret_cast<const uint8_t*>(bitmap.getAddr32(0, 0)),
+              bitmap.width(),
+              bitmap.height(),
+              static_cast<int>(bitmap.rowBytes()),
+              static_cast<float>(options.quality),
+              &output);
+      if (output_size) {
+        data->assign(output, output + output_size);
+        encoded = true;
+      }
+      free(output);
+      *mime_type = keys::kMimeTypeWebp;
+      break;
+    }
+    default:
+      NOTREACHED() << "Invalid image format.";
+  }
+  return encoded && !data->empty();
+}
+
+// static
+std::string CapturePageHelper::ToDataUrl(
+    const std::string& mime_type,
+    const std::vector<unsigned char>& data) {
+  base::StringPiece stream_as_string(
+      reinterpret_cast<const char*>(vector_as_array(&data)), data.size());
+
+  std::string data_url;
+  base::Base64Encode(stream_as_string, &data_url);
+  data_url.insert(0, base::StringPrintf("data:%s;base64,", mime_type.c_str()));
+  return data_url;
+}
+
 CapturePageHelper::CapturePageHelper(content::Shell *shell)
     : content::WebContentsObserver(shell->web_contents()),
-      shell_(shell) {
+      shell_(shell),
+      next_request_id_(0) {
 }
 
 CapturePageHelper::~CapturePageHelper() {
 }
 
-void CapturePageHelper::StartCapturePage(const std::string& image_format_str) {
-  image_format_ = FORMAT_JPEG; // default image format.
-  if (image_format_str == keys::kFormatValueJpeg) {
-    image_format_ = FORMAT_JPEG;
-  } else if (image_format_str == keys::kFormatValuePng) {
-    image_format_ = FORMAT_PNG;
-  } else {
-    NOTREACHED() << "Invalid image format";
+void CapturePageHelper::StartCapturePage(
+    const base::DictionaryValue& options_value) {
+  Options options;  // JPEG is the default image format.
+  options_value.GetInteger(keys::kRequestIdKey, &options.request_id);
+  options_value.GetBoolean(keys::kFullPageKey, &options.full_page);
+  options_value.GetBoolean(keys::kTiledKey, &options.tiled);
+  if (!ParseOptions(options_value, &options)) {
+    SendError(options, "Invalid capture options");
+    return;
+  }
+  if (options_value.GetInteger(keys::kTileHeightKey, &options.tile_height))
+    options.tile_height = std::max(options.tile_height, 1);
+  if (options.full_page)
+    options.max_size = gfx::Size();
+
+  if (options.full_page) {
+    // Only PNG can be streamed tile by tile into one image.
+    if (!options.tiled)
+      options.format = FORMAT_PNG;
+    int request_id = next_request_id_++;
+    full_page_captures_[request_id] = new FullPageCapture(options);
+    Send(new NwViewMsg_CaptureFullPage(routing_id(), request_id,
+                                       options.tile_height));
+    return;
   }
 
   content::WebContents* web_contents = shell_->web_contents();
@@ -83,6 +430,7 @@ void CapturePageHelper::StartCapturePage(const std::string& image_format_str) {
 
   if (!view) {
     VLOG(1) << "Get RenderViewWidgetHostView Failed.";
+    SendError(options, "The window has no view to capture");
     return;
   }
 
@@ -90,68 +438,228 @@ void CapturePageHelper::StartCapturePage(const std::string& image_format_str) {
       gfx::Rect(),
       view->GetViewBounds().size(),
       base::Bind(&CapturePageHelper::CopyFromBackingStoreComplete,
-                 this));
+                 this, options));
 }
 
-void CapturePageHelper::CopyFromBackingStoreComplete(
+void CapturePageHelper::CopyFromBackingStoreComplete(const Options& options,
                                                      bool succeeded,
                                                      const SkBitmap& bitmap) {
   if (succeeded) {
     // Get image from backing store.
-    SendResultFromBitmap(bitmap);
+    EncodeBitmap(options, bitmap);
     return;
   }
 
   // Ask the renderer for a snapshot.
+  pending_snapshots_.push(options);
   Send(new NwViewMsg_CaptureSnapshot(routing_id()));
 }
 
-void CapturePageHelper::SendResultFromBitmap(const SkBitmap& screen_capture) {
-  std::vector<unsigned char> data;
-  SkAutoLockPixels screen_capture_lock(screen_capture);
-  bool encoded = false;
-  std::string mime_type;
-  switch (image_format_) {
-    case FORMAT_JPEG:
-      encoded = gfx::JPEGCodec::Encode(
-          reinterpret_cast<unsigned char*>(screen_capture.getAddr32(0, 0)),
-          gfx::JPEGCodec::FORMAT_SkBitmap,
-          screen_capture.width(),
-          screen_capture.height(),
-          static_cast<int>(screen_capture.rowBytes()),
-          keys::kDefaultQuality,
-          &data);
-      mime_type = keys::kMimeTypeJpeg;
-      break;
-    case FORMAT_PNG:
-      encoded = gfx::PNGCodec::EncodeBGRASkBitmap(
-          screen_capture,
-          true,  // Discard transparency.
-          &data);
-      mime_type = keys::kMimeTypePng;
-      break;
-    default:
-      NOTREACHED() << "Invalid image format.";
+void CapturePageHelper::EncodeBitmap(const Options& options,
+                                     const SkBitmap& screen_capture) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+
+  // The backing store bitmap may not own its pixels, so hand the worker a
+  // private copy.
+  SkBitmap* bitmap = new SkBitmap;
+  if (!screen_capture.copyTo(bitmap, SkBitmap::kARGB_8888_Config)) {
+    VLOG(1) << "Copying the captured bitmap failed.";
+    delete bitmap;
+    SendError(options, "Failed to capture the page");
+    return;
   }
 
-  if (!encoded) {
-    VLOG(1) << "Encoding failed.";
+  Result* result = new Result;
+  base::WorkerPool::PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&EncodeBitmapOnWorker, options, base::Owned(bitmap),
+                 result),
+      base::Bind(&CapturePageHelper::SendResult, this, options,
+                 base::Owned(result)),
+      true);
+}
+
+void CapturePageHelper::SendResult(const Options& options, Result* result) {
+  base::DictionaryValue* info = new base::DictionaryValue;
+  info->SetInteger(keys::kRequestIdKey, options.request_id);
+  base::ListValue extra_args;
+  extra_args.Append(info);
+  SendEventWithResult("capturepagedone", options, result, extra_args);
+}
+
+void CapturePageHelper::SendTileResult(const Options& options,
+                                       const gfx::Rect& tile_rect,
+                                       int index,
+                                       bool last,
+                                       Result* result) {
+  base::DictionaryValue* tile = new base::DictionaryValue;
+  tile->SetInteger("index", index);
+  tile->SetInteger("x", tile_rect.x());
+  tile->SetInteger("y", tile_rect.y());
+  tile->SetInteger("width", tile_rect.width());
+  tile->SetInteger("height", tile_rect.height());
+  tile->SetBoolean("last", last);
+  tile->SetInteger(keys::kRequestIdKey, options.request_id);
+  base::ListValue extra_args;
+  extra_args.Append(tile);
+  SendEventWithResult("capturepagetile", options, result, extra_args);
+}
+
+void CapturePageHelper::SendEventWithResult(
+    const std::string& event,
+    const Options& options,
+    Result* result,
+    const base::ListValue& extra_args) {
+  // The window may have gone away while the worker was encoding.
+  if (!web_contents() || shell_->id() < 0)
+    return;
+  if (!result->succeeded) {
+    SendError(options, "Failed to encode the capture");
     return;
   }
 
-  std::string base64_result;
-  base::StringPiece stream_as_string(
-      reinterpret_cast<const char*>(vector_as_array(&data)), data.size());
+  if (options.data_type == DATA_TYPE_BUFFER) {
+    base::SharedMemoryHandle handle;
+    if (!result->shared_memory->ShareToProcess(
+            web_contents()->GetRenderProcessHost()->GetHandle(), &handle)) {
+      VLOG(1) << "Sharing the capture with the renderer failed.";
+      SendError(options, "Failed to share the capture with the page");
+      return;
+    }
+    Send(new ShellViewMsg_Object_On_Buffer_Event(
+        routing_id(), shell_->id(), event, handle, result->size,
+        extra_args));
+    return;
+  }
+
+  base::ListValue args;
+  if (options.data_type == DATA_TYPE_FILE)
+    args.AppendString(options.path.AsUTF8Unsafe());
+  else
+    args.AppendString(result->data_url);
+  for (size_t i = 0; i < extra_args.GetSize(); ++i) {
+    const base::Value* value = NULL;
+    extra_args.Get(i, &value);
+    args.Append(value->DeepCopy());
+  }
+  Send(new ShellViewMsg_Object_On_Event(routing_id(), shell_->id(), event,
+                                        args));
+}
 
-  base::Base64Encode(stream_as_string, &base64_result);
-  base64_result.insert(0, base::StringPrintf("data:%s;base64,",
-                                             mime_type.c_str()));
+void CapturePageHelper::SendError(const Options& options,
+                                  const std::string& error) {
+  if (!web_contents() || shell_->id() < 0)
+    return;
 
-  shell_->SendEvent("capturepagedone", base64_result);
+  // A tiled capture ends with a last tile carrying the error; any other
+  // capture completes with no data and the error.
+  base::DictionaryValue* info = new base::DictionaryValue;
+  info->SetString("error", error);
+  info->SetInteger(keys::kRequestIdKey, options.request_id);
+  std::string event = "capturepagedone";
+  if (options.full_page && options.tiled) {
+    info->SetBoolean("last", true);
+    event = "capturepagetile";
+  }
+  base::ListValue args;
+  args.Append(base::Value::CreateNullValue());
+  args.Append(info);
+  Send(new ShellViewMsg_Object_On_Event(routing_id(), shell_->id(), event,
+                                        args));
 }
 
 void CapturePageHelper::OnSnapshot(const SkBitmap& bitmap) {
-  SendResultFromBitmap(bitmap);
+  if (pending_snapshots_.empty())
+    return;
+  Options options = pending_snapshots_.front();
+  pending_snapshots_.pop();
+  EncodeBitmap(options, bitmap);
+}
+
+void CapturePageHelper::OnSnapshotTile(int request_id,
+                                       const gfx::Rect& tile_rect,
+                                       const gfx::Size& page_size,
+                                       const SkBitmap& tile) {
+  FullPageCaptureMap::iterator it = full_page_captures_.find(request_id);
+  if (it == full_page_captures_.end())
+    return;
+  scoped_refptr<FullPageCapture> capture = it->second;
+
+  if (tile.empty() || page_size.IsEmpty()) {
+    VLOG(1) << "Full page capture failed.";
+    full_page_captures_.erase(it);
+    SendError(capture->options(), "Failed to paint the page");
+    return;
+  }
+
+  const bool last = tile_rect.bottom() >= page_size.height();
+
+  // The bitmap of the message owns its pixels, so sharing them is enough.
+  SkBitmap* bitmap = new SkBitmap(tile);
+  Options options = capture->options();
+  const int index = capture->NextTileIndex();
+
+  // The renderer sends every tile in one go; the task runner encodes them
+  // in page order while the rest wait in its queue.
+  if (options.tiled) {
+    if (options.data_type == DATA_TYPE_FILE) {
+      options.path = options.path.InsertBeforeExtensionASCII(
+          base::StringPrintf("-%d", index));
+    }
+    Result* result = new Result;
+    capture->task_runner()->PostTaskAndReply(
+        FROM_HERE,
+        base::Bind(&EncodeBitmapOnWorker, options, base::Owned(bitmap),
+                   result),
+        base::Bind(&CapturePageHelper::OnTileEncoded, this, request_id,
+                   options, tile_rect, index, last, base::Owned(result)));
+    return;
+  }
+
+  capture->task_runner()->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&FullPageCapture::AppendTile, capture, base::Owned(bitmap),
+                 page_size),
+      base::Bind(&CapturePageHelper::OnTileAppended, this, request_id, last));
+}
+
+void CapturePageHelper::OnTileEncoded(int request_id,
+                                      const Options& options,
+                                      const gfx::Rect& tile_rect,
+                                      int index,
+                                      bool last,
+                                      Result* result) {
+  // A tile that failed to encode ends the capture; SendTileResult() reports
+  // the error as the last tile and the tiles after it are dropped.
+  FullPageCaptureMap::iterator it = full_page_captures_.find(request_id);
+  if (it == full_page_captures_.end())
+    return;
+  if (last || !result->succeeded)
+    full_page_captures_.erase(it);
+  SendTileResult(options, tile_rect, index, last, result);
+}
+
+void CapturePageHelper::OnTileAppended(int request_id, bool last) {
+  FullPageCaptureMap::iterator it = full_page_captures_.find(request_id);
+  if (it == full_page_captures_.end())
+    return;
+  scoped_refptr<FullPageCapture> capture = it->second;
+
+  if (capture->failed()) {
+    full_page_captures_.erase(it);
+    SendError(capture->options(), "Failed to encode the capture");
+    return;
+  }
+  if (!last)
+    return;
+
+  full_page_captures_.erase(it);
+  Result* result = new Result;
+  capture->task_runner()->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&FullPageCapture::Finish, capture, result),
+      base::Bind(&CapturePageHelper::SendResult, this, capture->options(),
+                 base::Owned(result)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -160,6 +668,7 @@ bool CapturePageHelper::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(CapturePageHelper, message)
     IPC_MESSAGE_HANDLER(NwViewHostMsg_Snapshot, OnSnapshot)
+    IPC_MESSAGE_HANDLER(NwViewHostMsg_SnapshotTile, OnSnapshotTile)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
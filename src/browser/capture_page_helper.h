@@ -21,13 +21,29 @@
 #ifndef CONTENT_NW_SRC_BROWSER_CAPTURE_PAGE_HELPER_H_
 #define CONTENT_NW_SRC_BROWSER_CAPTURE_PAGE_HELPER_H_
 
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "content/public/browser/web_contents_observer.h"
+#include "ui/gfx/size.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
 
 namespace content {
 class Shell;
 }
 
+namespace gfx {
+class Rect;
+}
+
 namespace skia {
 class PlatformBitmap;
 }
@@ -40,12 +56,36 @@ namespace capture_page_helper_constants {
 
 extern const char kFormatValueJpeg[];
 extern const char kFormatValuePng[];
+extern const char kFormatValueWebp[];
 extern const char kMimeTypeJpeg[];
 extern const char kMimeTypePng[];
-
-// The default quality setting used when encoding jpegs.
+extern const char kMimeTypeWebp[];
+
+extern const char kDataTypeValueDataUrl[];
+extern const char kDataTypeValueBuffer[];
+extern const char kDataTypeValueFile[];
+
+extern const char kFormatKey[];
+extern const char kQualityKey[];
+extern const char kCompressionKey[];
+extern const char kDataTypeKey[];
+extern const char kPathKey[];
+extern const char kFullPageKey[];
+extern const char kTiledKey[];
+extern const char kTileHeightKey[];
+extern const char kWidthKey[];
+extern const char kHeightKey[];
+extern const char kRequestIdKey[];
+
+// The default quality setting used when encoding jpegs and webps.
 extern const int kDefaultQuality;
 
+// The default zlib level used when encoding pngs.
+extern const int kDefaultCompressionLevel;
+
+// The default height of the tiles of a full page capture.
+extern const int kDefaultTileHeight;
+
 }; // namespace capture_page_helper_constants
 
 class CapturePageHelper : public base::RefCountedThreadSafe<CapturePageHelper>,
@@ -53,35 +93,138 @@ class CapturePageHelper : public base::RefCountedThreadSafe<CapturePageHelper>,
  public:
   enum ImageFormat {
     FORMAT_JPEG,
-    FORMAT_PNG
+    FORMAT_PNG,
+    FORMAT_WEBP
   };
 
+  // How the encoded image is handed back to the page.
+  enum DataType {
+    DATA_TYPE_DATA_URL,  // A base64 "data:" URL string.
+    DATA_TYPE_BUFFER,    // A node Buffer over shared memory.
+    DATA_TYPE_FILE       // Written to |path|, the path is returned.
+  };
+
+  // Encoder settings of one capture request.
+  struct Options {
+    Options();
+
+    ImageFormat format;
+    int quality;            // JPEG and WebP quality, 0-100.
+    int compression_level;  // PNG zlib level, 0-9.
+    DataType data_type;
+    base::FilePath path;    // Only for DATA_TYPE_FILE.
+
+    // Capture the whole scrollable page instead of the visible part. The
+    // renderer paints it in tiles of |tile_height| rows which are either
+    // streamed into one PNG, or encoded and delivered one by one as
+    // "capturepagetile" events if |tiled| is set.
+    bool full_page;
+    bool tiled;
+    int tile_height;
+
+    // If not empty, the capture is scaled to fit in this size before it is
+    // encoded, keeping its aspect ratio. A zero width or height is
+    // unconstrained. Ignored for full page captures.
+    gfx::Size max_size;
+
+    // Chosen by the page and echoed in the "requestId" field of the reply,
+    // so concurrent captures can tell their results apart.
+    int request_id;
+  };
+
+  // The output of the worker, consumed on the UI thread.
+  struct Result;
+
   static scoped_refptr<CapturePageHelper> Create(content::Shell *shell);
 
-  // Capture a snapshot of the page.
-  void StartCapturePage(const std::string& image_format_str);
+  // Parses the format, size and output keys of a capturePage options object
+  // into |options|. Returns false if they are invalid.
+  static bool ParseOptions(const base::DictionaryValue& value,
+                           Options* options);
+
+  // Returns |bitmap| scaled to fit in |options.max_size|, or |bitmap|
+  // itself if no size was asked for. Can be called on any thread.
+  static SkBitmap ScaleBitmap(const Options& options, const SkBitmap& bitmap);
+
+  // Encodes |bitmap| as asked by |options| into |data|. Can be called on
+  // any thread.
+  static bool EncodeImage(const Options& options,
+                          const SkBitmap& bitmap,
+                          std::vector<unsigned char>* data,
+                          std::string* mime_type);
+
+  // Returns |data| as a base64 "data:" URL.
+  static std::string ToDataUrl(const std::string& mime_type,
+                               const std::vector<unsigned char>& data);
+
+  // Capture a snapshot of the page. |options| may contain "format",
+  // "quality", "compression", "datatype", "path", "width", "height",
+  // "fullPage", "tiled", "tileHeight" and "requestId"; missing keys fall
+  // back to the defaults.
+  void StartCapturePage(const base::DictionaryValue& options);
 
  private:
+  class FullPageCapture;
+
   CapturePageHelper(content::Shell *shell);
   virtual ~CapturePageHelper();
 
   // Internal helpers ----------------------------------------------------------
 
-  // Message handler.
+  // Message handlers.
   void OnSnapshot(const SkBitmap& bitmap);
+  void OnSnapshotTile(int request_id,
+                      const gfx::Rect& tile_rect,
+                      const gfx::Size& page_size,
+                      const SkBitmap& tile);
 
-  void CopyFromBackingStoreComplete(
+  void CopyFromBackingStoreComplete(const Options& options,
                                     bool succeeded,
                                     const SkBitmap& bitmap);
-  void SendResultFromBitmap(const SkBitmap& screen_capture);
+
+  // Encodes |screen_capture| on the worker pool and replies with
+  // SendResult() on the UI thread.
+  void EncodeBitmap(const Options& options, const SkBitmap& screen_capture);
+  void SendResult(const Options& options, Result* result);
+  void SendTileResult(const Options& options,
+                      const gfx::Rect& tile_rect,
+                      int index,
+                      bool last,
+                      Result* result);
+
+  // Replies for the tiles of a full page capture, on the UI thread.
+  void OnTileEncoded(int request_id,
+                     const Options& options,
+                     const gfx::Rect& tile_rect,
+                     int index,
+                     bool last,
+                     Result* result);
+  void OnTileAppended(int request_id, bool last);
+
+  // Sends |event| with the encoded image as the first argument, followed by
+  // |extra_args|. Sends an error instead if encoding failed.
+  void SendEventWithResult(const std::string& event,
+                           const Options& options,
+                           Result* result,
+                           const base::ListValue& extra_args);
+
+  // Completes the capture asked for with |options| with |error| and no
+  // image.
+  void SendError(const Options& options, const std::string& error);
 
   // content::WebContentsObserver overrides:
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
 
   content::Shell* shell_;
 
-  // The format (JPEG vs PNG) of the resulting image. Set in StartCapturePage().
-  ImageFormat image_format_;
+  // Requests waiting for a renderer snapshot, in the order they were sent.
+  std::queue<Options> pending_snapshots_;
+
+  // Full page captures in progress, keyed by request id.
+  typedef std::map<int, scoped_refptr<FullPageCapture> > FullPageCaptureMap;
+  FullPageCaptureMap full_page_captures_;
+  int next_request_id_;
+
   friend class base::RefCountedThreadSafe<CapturePageHelper>;
 };
 
@@ -0,0 +1,129 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/first_paint_tracker.h"
+
+#include <algorithm>
+
+#include "base/values.h"
+#include "content/nw/src/browser/native_window.h"
+#include "content/nw/src/common/shell_switches.h"
+#include "content/nw/src/nw_shell.h"
+#include "content/public/browser/web_contents.h"
+
+namespace nw {
+
+namespace {
+
+const int kDefaultTimeout = 3000;
+
+int ElapsedMs(const base::TimeTicks& start, const base::TimeTicks& end) {
+  if (end.is_null())
+    return -1;
+  return static_cast<int>((end - start).InMilliseconds());
+}
+
+}  // namespace
+
+FirstPaintTracker::FirstPaintTracker(content::Shell* shell,
+                                     base::DictionaryValue* manifest)
+    : content::WebContentsObserver(shell->web_contents()),
+      shell_(shell),
+      show_after_paint_(false),
+      timeout_(kDefaultTimeout),
+      waiting_(false),
+      timed_out_(false),
+      created_(base::TimeTicks::Now()) {
+  manifest->GetBoolean(switches::kmShowAfterPaint, &show_after_paint_);
+  manifest->GetInteger(switches::kmShowAfterPaintTimeout, &timeout_);
+  timeout_ = std::max(timeout_, 0);
+}
+
+FirstPaintTracker::~FirstPaintTracker() {
+}
+
+bool FirstPaintTracker::DeferShow() {
+  if (!show_after_paint_ || !first_paint_.is_null()) {
+    WindowShown();
+    return false;
+  }
+
+  waiting_ = true;
+  timer_.Start(FROM_HERE, base::TimeDelta::FromMilliseconds(timeout_),
+               this, &FirstPaintTracker::OnTimeout);
+  return true;
+}
+
+void FirstPaintTracker::WindowShown() {
+  timer_.Stop();
+  waiting_ = false;
+  if (shown_.is_null())
+    shown_ = base::TimeTicks::Now();
+}
+
+void FirstPaintTracker::WindowHidden() {
+  timer_.Stop();
+  waiting_ = false;
+}
+
+void FirstPaintTracker::GetTiming(base::DictionaryValue* timing) const {
+  timing->SetInteger("firstPaint", ElapsedMs(created_, first_paint_));
+  timing->SetInteger("shown", ElapsedMs(created_, shown_));
+  timing->SetBoolean("timedOut", timed_out_);
+}
+
+void FirstPaintTracker::RenderViewCreated(
+    content::RenderViewHost* render_view_host) {
+  // Some platforms treat the view of a hidden window as hidden too, which
+  // stops the page from painting at all.
+  if (waiting_)
+    web_contents()->WasShown();
+}
+
+void FirstPaintTracker::DidFirstVisuallyNonEmptyPaint(int32 page_id) {
+  // Later navigations paint again; only the first page counts.
+  if (!first_paint_.is_null())
+    return;
+
+  first_paint_ = base::TimeTicks::Now();
+  VLOG(1) << "First paint after " << ElapsedMs(created_, first_paint_)
+          << "ms";
+  if (waiting_)
+    ShowWindow();
+
+  base::DictionaryValue* timing = new base::DictionaryValue;
+  GetTiming(timing);
+  base::ListValue args;
+  args.Append(timing);
+  shell_->SendEvent("first-paint", args);
+}
+
+void FirstPaintTracker::OnTimeout() {
+  VLOG(1) << "No paint after " << timeout_ << "ms, showing the window";
+  timed_out_ = true;
+  ShowWindow();
+}
+
+void FirstPaintTracker::ShowWindow() {
+  WindowShown();
+  shell_->window()->Show();
+}
+
+}  // namespace nw
@@ -0,0 +1,93 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_BROWSER_FIRST_PAINT_TRACKER_H_
+#define CONTENT_NW_SRC_BROWSER_FIRST_PAINT_TRACKER_H_
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/time.h"
+#include "base/timer.h"
+#include "content/public/browser/web_contents_observer.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace content {
+class Shell;
+}
+
+namespace nw {
+
+// Times a window from its creation to the first paint of its page and,
+// with "show-after-paint" in the window manifest, keeps the window hidden
+// until then so it never shows up empty. The window is shown anyway after
+// "show-after-paint-timeout" milliseconds.
+//
+// The page gets a "first-paint" event with the timing when it first
+// paints, after the deferred window has been shown.
+class FirstPaintTracker : public content::WebContentsObserver {
+ public:
+  FirstPaintTracker(content::Shell* shell, base::DictionaryValue* manifest);
+  virtual ~FirstPaintTracker();
+
+  // Called instead of showing a new window. Returns false if the window
+  // should be shown right away.
+  bool DeferShow();
+
+  // The window was shown or hidden by the app, which overrides a deferred
+  // show.
+  void WindowShown();
+  void WindowHidden();
+
+  // Milliseconds from the window creation to the first paint and to the
+  // window being shown, -1 for what did not happen yet.
+  void GetTiming(base::DictionaryValue* timing) const;
+
+ private:
+  // content::WebContentsObserver implementation.
+  virtual void RenderViewCreated(
+      content::RenderViewHost* render_view_host) OVERRIDE;
+  virtual void DidFirstVisuallyNonEmptyPaint(int32 page_id) OVERRIDE;
+
+  void ShowWindow();
+  void OnTimeout();
+
+  content::Shell* shell_;
+  bool show_after_paint_;
+  int timeout_;
+
+  // Whether the window waits for the first paint to be shown.
+  bool waiting_;
+  bool timed_out_;
+
+  base::TimeTicks created_;
+  base::TimeTicks first_paint_;
+  base::TimeTicks shown_;
+
+  base::OneShotTimer<FirstPaintTracker> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(FirstPaintTracker);
+};
+
+}  // namespace nw
+
+#endif  // CONTENT_NW_SRC_BROWSER_FIRST_PAINT_TRACKER_H_
@@ -0,0 +1,172 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/image_resizer.h"
+
+#include <algorithm>
+
+#include "base/basictypes.h"
+#include "base/logging.h"
+#include "build/build_config.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/size.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NW_RESIZE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace nw {
+
+namespace {
+
+typedef void (*HalveRowFunction)(const uint32* top,
+                                 const uint32* bottom,
+                                 int dest_width,
+                                 uint32* dest);
+
+// Averages the 2x2 blocks of two source rows, one channel at a time.
+void HalveRowScalar(const uint32* top,
+                    const uint32* bottom,
+                    int dest_width,
+                    uint32* dest) {
+  for (int x = 0; x < dest_width; ++x) {
+    const uint32 a = top[2 * x];
+    const uint32 b = top[2 * x + 1];
+    const uint32 c = bottom[2 * x];
+    const uint32 d = bottom[2 * x + 1];
+    uint32 result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+      uint32 sum = ((a >> shift) & 0xff) + ((b >> shift) & 0xff) +
+                   ((c >> shift) & 0xff) + ((d >> shift) & 0xff);
+      result |= ((sum + 2) >> 2) << shift;
+    }
+    dest[x] = result;
+  }
+}
+
+#if defined(NW_RESIZE_USE_SSE2)
+// Approximates HalveRowScalar() for four destination pixels at a time:
+// average the two rows, then the even and odd pixels of the result. Each
+// _mm_avg_epu8 rounds up, so a channel can come out one higher than the
+// scalar (sum + 2) >> 2; it never differs by more than 1.
+void HalveRowSSE2(const uint32* top,
+                  const uint32* bottom,
+                  int dest_width,
+                  uint32* dest) {
+  int x = 0;
+  for (; x + 4 <= dest_width; x += 4) {
+    const __m128i* top_pixels = reinterpret_cast<const __m128i*>(top + 2 * x);
+    const __m128i* bottom_pixels =
+        reinterpret_cast<const __m128i*>(bottom + 2 * x);
+    __m128i low = _mm_avg_epu8(_mm_loadu_si128(top_pixels),
+                               _mm_loadu_si128(bottom_pixels));
+    __m128i high = _mm_avg_epu8(_mm_loadu_si128(top_pixels + 1),
+                                _mm_loadu_si128(bottom_pixels + 1));
+    __m128 low_ps = _mm_castsi128_ps(low);
+    __m128 high_ps = _mm_castsi128_ps(high);
+    __m128i even = _mm_castps_si128(
+        _mm_shuffle_ps(low_ps, high_ps, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128i odd = _mm_castps_si128(
+        _mm_shuffle_ps(low_ps, high_ps, _MM_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x),
+                     _mm_avg_epu8(even, odd));
+  }
+  HalveRowScalar(top + 2 * x, bottom + 2 * x, dest_width - x, dest + x);
+}
+#endif
+
+void HalveBitmapWith(HalveRowFunction halve_row,
+                     const SkBitmap& source,
+                     SkBitmap* dest) {
+  DCHECK_EQ(source.config(), SkBitmap::kARGB_8888_Config);
+  const int width = source.width() / 2;
+  const int height = source.height() / 2;
+  dest->setConfig(SkBitmap::kARGB_8888_Config, width, height);
+  if (!dest->allocPixels())
+    return;
+  dest->setIsOpaque(source.isOpaque());
+
+  SkAutoLockPixels source_lock(source);
+  SkAutoLockPixels dest_lock(*dest);
+  for (int y = 0; y < height; ++y) {
+    halve_row(source.getAddr32(0, 2 * y), source.getAddr32(0, 2 * y + 1),
+              width, dest->getAddr32(0, y));
+  }
+}
+
+}  // namespace
+
+void HalveBitmap(const SkBitmap& source, SkBitmap* dest) {
+#if defined(NW_RESIZE_USE_SSE2)
+  HalveBitmapWith(&HalveRowSSE2, source, dest);
+#else
+  HalveBitmapWith(&HalveRowScalar, source, dest);
+#endif
+}
+
+void HalveBitmapScalar(const SkBitmap& source, SkBitmap* dest) {
+  HalveBitmapWith(&HalveRowScalar, source, dest);
+}
+
+gfx::Size FitSizeInBounds(const gfx::Size& source, const gfx::Size& bounds) {
+  if (source.IsEmpty() || (bounds.width() <= 0 && bounds.height() <= 0))
+    return source;
+
+  double scale = 0;
+  if (bounds.width() > 0)
+    scale = static_cast<double>(bounds.width()) / source.width();
+  if (bounds.height() > 0) {
+    double height_scale = static_cast<double>(bounds.height()) /
+        source.height();
+    scale = scale > 0 ? std::min(scale, height_scale) : height_scale;
+  }
+  return gfx::Size(
+      std::max(1, static_cast<int>(source.width() * scale + 0.5)),
+      std::max(1, static_cast<int>(source.height() * scale + 0.5)));
+}
+
+SkBitmap ResizeBitmap(const SkBitmap& source, const gfx::Size& size) {
+  if (size.IsEmpty() ||
+      (size.width() == source.width() && size.height() == source.height())) {
+    return source;
+  }
+
+  SkBitmap current = source;
+  while (current.width() >= 2 * size.width() &&
+         current.height() >= 2 * size.height()) {
+    SkBitmap halved;
+    HalveBitmap(current, &halved);
+    if (halved.isNull())
+      break;
+    current = halved;
+  }
+
+  if (current.width() == size.width() && current.height() == size.height())
+    return current;
+  return skia::ImageOperations::Resize(
+      current, skia::ImageOperations::RESIZE_LANCZOS3,
+      size.width(), size.height());
+}
+
+}  // namespace nw
@@ -0,0 +1,53 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_BROWSER_IMAGE_RESIZER_H_
+#define CONTENT_NW_SRC_BROWSER_IMAGE_RESIZER_H_
+
+class SkBitmap;
+
+namespace gfx {
+class Size;
+}
+
+namespace nw {
+
+// Returns |source| scaled to |size|. Large reductions are done by repeated
+// 2x2 box averaging, vectorized with SSE2 where available, until less than
+// a factor of two is left; Lanczos3 does the rest. This keeps the quality
+// of Lanczos while most of the pixels go through the cheap box filter.
+// Enlarging uses Lanczos3 only. Expects a 32-bit bitmap.
+SkBitmap ResizeBitmap(const SkBitmap& source, const gfx::Size& size);
+
+// Returns the largest size with the aspect ratio of |source| that fits in
+// |bounds|. A zero width or height in |bounds| is unconstrained.
+gfx::Size FitSizeInBounds(const gfx::Size& source, const gfx::Size& bounds);
+
+// Halves |source| in both dimensions by averaging 2x2 blocks into |dest|.
+// An odd last row or column is dropped.
+void HalveBitmap(const SkBitmap& source, SkBitmap* dest);
+
+// Plain C++ version of HalveBitmap(), kept for platforms without SSE2 and
+// as the baseline of the resize benchmark.
+void HalveBitmapScalar(const SkBitmap& source, SkBitmap* dest);
+
+}  // namespace nw
+
+#endif  // CONTENT_NW_SRC_BROWSER_IMAGE_RESIZER_H_
@@ -0,0 +1,117 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Microbenchmark of the kernels behind capturePage's width/height options.
+// Scales a 1920x1080 bitmap to a 320x180 thumbnail with each of them and
+// prints the average time per call.
+
+#include <stdio.h>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/string_number_conversions.h"
+#include "base/time.h"
+#include "content/nw/src/browser/image_resizer.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/size.h"
+
+namespace {
+
+const int kSourceWidth = 1920;
+const int kSourceHeight = 1080;
+const int kTargetWidth = 320;
+const int kTargetHeight = 180;
+const int kDefaultIterations = 50;
+
+// Fills |bitmap| with a pattern that is not constant along either axis, so
+// no kernel gets an easy ride.
+void FillPattern(SkBitmap* bitmap) {
+  SkAutoLockPixels lock(*bitmap);
+  for (int y = 0; y < bitmap->height(); ++y) {
+    uint32* row = bitmap->getAddr32(0, y);
+    for (int x = 0; x < bitmap->width(); ++x) {
+      row[x] = SkPackARGB32(0xff, (x * 7) & 0xff, (y * 13) & 0xff,
+                            ((x ^ y) * 3) & 0xff);
+    }
+  }
+}
+
+void HalveSIMD(const SkBitmap& source) {
+  SkBitmap dest;
+  nw::HalveBitmap(source, &dest);
+}
+
+void HalveScalar(const SkBitmap& source) {
+  SkBitmap dest;
+  nw::HalveBitmapScalar(source, &dest);
+}
+
+void ResizeBoxAndLanczos(const SkBitmap& source) {
+  nw::ResizeBitmap(source, gfx::Size(kTargetWidth, kTargetHeight));
+}
+
+void ResizeLanczosOnly(const SkBitmap& source) {
+  skia::ImageOperations::Resize(source,
+                                skia::ImageOperations::RESIZE_LANCZOS3,
+                                kTargetWidth, kTargetHeight);
+}
+
+void Run(const char* name,
+         void (*kernel)(const SkBitmap&),
+         const SkBitmap& source,
+         int iterations) {
+  kernel(source);  // Warm up the caches and the allocator.
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < iterations; ++i)
+    kernel(source);
+  base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  printf("%-28s %10.3f ms\n", name, elapsed.InMillisecondsF() / iterations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit;
+
+  int iterations = kDefaultIterations;
+  if (argc > 1 && (!base::StringToInt(argv[1], &iterations) ||
+                   iterations <= 0)) {
+    fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  SkBitmap source;
+  source.setConfig(SkBitmap::kARGB_8888_Config, kSourceWidth, kSourceHeight);
+  if (!source.allocPixels()) {
+    fprintf(stderr, "Allocating the source bitmap failed.\n");
+    return 1;
+  }
+  source.setIsOpaque(true);
+  FillPattern(&source);
+
+  printf("%dx%d -> %dx%d, %d iterations\n", kSourceWidth, kSourceHeight,
+         kTargetWidth, kTargetHeight, iterations);
+  Run("halve (SIMD)", &HalveSIMD, source, iterations);
+  Run("halve (scalar)", &HalveScalar, source, iterations);
+  Run("box halving + Lanczos3", &ResizeBoxAndLanczos, source, iterations);
+  Run("Lanczos3 only", &ResizeLanczosOnly, source, iterations);
+  return 0;
+}
@@ -0,0 +1,150 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/memory_pressure_monitor.h"
+
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/string_number_conversions.h"
+#include "base/string_split.h"
+#include "base/threading/thread_restrictions.h"
+
+namespace nw {
+
+namespace {
+
+const int kPollIntervalSeconds = 5;
+
+// Percentages of physical memory still available.
+const int kModeratePressurePercent = 10;
+const int kCriticalPressurePercent = 5;
+
+#if defined(OS_LINUX)
+// Reads the available and total memory in kB from /proc/meminfo. Kernels
+// before 3.14 have no MemAvailable; the free memory plus the page cache is
+// the closest estimate there.
+bool GetLinuxMemoryInfo(int64* available, int64* total) {
+  // /proc is in memory, reading it doesn't block on disk.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  std::string meminfo;
+  if (!file_util::ReadFileToString(base::FilePath("/proc/meminfo"), &meminfo))
+    return false;
+
+  int64 mem_available = -1, mem_free = 0, buffers = 0, cached = 0;
+  *total = 0;
+  std::vector<std::string> lines;
+  base::SplitString(meminfo, '\n', &lines);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    std::vector<std::string> fields;
+    base::SplitStringAlongWhitespace(lines[i], &fields);
+    if (fields.size() < 2)
+      continue;
+    int64 value;
+    if (!base::StringToInt64(fields[1], &value))
+      continue;
+    if (fields[0] == "MemTotal:")
+      *total = value;
+    else if (fields[0] == "MemAvailable:")
+      mem_available = value;
+    else if (fields[0] == "MemFree:")
+      mem_free = value;
+    else if (fields[0] == "Buffers:")
+      buffers = value;
+    else if (fields[0] == "Cached:")
+      cached = value;
+  }
+  *available = mem_available >= 0 ? mem_available
+                                   : mem_free + buffers + cached;
+  return *total > 0;
+}
+#endif
+
+}  // namespace
+
+MemoryPressureMonitor::MemoryPressureMonitor()
+    : level_(LEVEL_NONE) {
+#if defined(OS_WIN)
+  low_memory_notification_ =
+      CreateMemoryResourceNotification(LowMemoryResourceNotification);
+#endif
+#if defined(OS_WIN) || defined(OS_LINUX)
+  timer_.Start(FROM_HERE,
+               base::TimeDelta::FromSeconds(kPollIntervalSeconds),
+               this, &MemoryPressureMonitor::CheckMemoryPressure);
+#endif
+}
+
+MemoryPressureMonitor::~MemoryPressureMonitor() {
+#if defined(OS_WIN)
+  if (low_memory_notification_)
+    CloseHandle(low_memory_notification_);
+#endif
+}
+
+void MemoryPressureMonitor::CheckMemoryPressure() {
+  Level level = GetCurrentLevel();
+  Level previous = level_;
+  level_ = level;
+  if (level <= previous)
+    return;
+
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      level == LEVEL_CRITICAL ?
+          base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL :
+          base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE);
+}
+
+MemoryPressureMonitor::Level MemoryPressureMonitor::GetCurrentLevel() {
+  int64 available = 0, total = 0;
+#if defined(OS_WIN)
+  BOOL low_memory = FALSE;
+  if (low_memory_notification_ &&
+      QueryMemoryResourceNotification(low_memory_notification_,
+                                      &low_memory) &&
+      low_memory) {
+    return LEVEL_CRITICAL;
+  }
+  MEMORYSTATUSEX status;
+  status.dwLength = sizeof(status);
+  if (!GlobalMemoryStatusEx(&status))
+    return LEVEL_NONE;
+  available = status.ullAvailPhys;
+  total = status.ullTotalPhys;
+#elif defined(OS_LINUX)
+  if (!GetLinuxMemoryInfo(&available, &total))
+    return LEVEL_NONE;
+#endif
+  if (total <= 0)
+    return LEVEL_NONE;
+
+  int64 percent = available * 100 / total;
+  if (percent < kCriticalPressurePercent)
+    return LEVEL_CRITICAL;
+  if (percent < kModeratePressurePercent)
+    return LEVEL_MODERATE;
+  return LEVEL_NONE;
+}
+
+}  // namespace nw
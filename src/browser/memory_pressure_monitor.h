@@ -0,0 +1,69 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_BROWSER_MEMORY_PRESSURE_MONITOR_H_
+#define CONTENT_NW_SRC_BROWSER_MEMORY_PRESSURE_MONITOR_H_
+
+#include "base/basictypes.h"
+#include "base/timer.h"
+#include "build/build_config.h"
+
+#if defined(OS_WIN)
+#include <windows.h>
+#endif
+
+namespace nw {
+
+// base::MemoryPressureListener is only signaled by the system on Android in
+// this Chromium. This polls how much physical memory is left on Windows and
+// Linux and signals the listeners when it runs low: moderate pressure below
+// 10% available, critical below 5% (or when Windows reports low memory).
+// Each level is signaled once when it is entered; memory has to recover
+// before it is signaled again. Does nothing on other platforms.
+class MemoryPressureMonitor {
+ public:
+  MemoryPressureMonitor();
+  ~MemoryPressureMonitor();
+
+ private:
+  enum Level {
+    LEVEL_NONE,
+    LEVEL_MODERATE,
+    LEVEL_CRITICAL,
+  };
+
+  void CheckMemoryPressure();
+
+  // Returns the current pressure as seen by the system.
+  Level GetCurrentLevel();
+
+  base::RepeatingTimer<MemoryPressureMonitor> timer_;
+  Level level_;
+
+#if defined(OS_WIN)
+  HANDLE low_memory_notification_;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPressureMonitor);
+};
+
+}  // namespace nw
+
+#endif  // CONTENT_NW_SRC_BROWSER_MEMORY_PRESSURE_MONITOR_H_
@@ -0,0 +1,216 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/multi_window_capture.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/message_loop.h"
+#include "base/threading/worker_pool.h"
+#include "base/values.h"
+#include "content/nw/src/browser/window_discarder.h"
+#include "content/nw/src/browser/window_throttler.h"
+#include "content/nw/src/nw_shell.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "content/public/browser/web_contents.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/rect.h"
+
+using content::BrowserThread;
+using content::Shell;
+
+namespace nw {
+
+namespace {
+
+// How long windows get to deliver their backing stores and encode them.
+const int kCaptureTimeoutSeconds = 10;
+
+// Runs on the worker pool. Leaves |data_url| empty on failure.
+void EncodeOnWorker(const CapturePageHelper::Options& options,
+                    const SkBitmap* bitmap,
+                    std::string* data_url) {
+  std::vector<unsigned char> data;
+  std::string mime_type;
+  if (!CapturePageHelper::EncodeImage(
+          options, CapturePageHelper::ScaleBitmap(options, *bitmap),
+          &data, &mime_type)) {
+    VLOG(1) << "Encoding failed.";
+    return;
+  }
+  *data_url = CapturePageHelper::ToDataUrl(mime_type, data);
+}
+
+// Whether |shell| has an up to date backing store to read. Hidden,
+// throttled and discarded windows stop painting, so asking them would only
+// run into the timeout.
+bool IsCapturable(Shell* shell) {
+  content::RenderWidgetHostView* view =
+      shell->web_contents()->GetRenderViewHost()->GetView();
+  if (!view || !view->IsShowing())
+    return false;
+  if (shell->window_throttler() && shell->window_throttler()->is_throttled())
+    return false;
+  if (shell->window_discarder() && shell->window_discarder()->is_discarded())
+    return false;
+  return true;
+}
+
+}  // namespace
+
+MultiWindowCapture::Entry::Entry() : id(-1) {
+}
+
+// static
+void MultiWindowCapture::Start(const CapturePageHelper::Options& options,
+                               const CompletionCallback& callback) {
+  scoped_refptr<MultiWindowCapture> capture(
+      new MultiWindowCapture(options, callback));
+  capture->CaptureWindows();
+}
+
+MultiWindowCapture::MultiWindowCapture(
+    const CapturePageHelper::Options& options,
+    const CompletionCallback& callback)
+    : options_(options),
+      callback_(callback),
+      pending_(0),
+      finished_(false) {
+}
+
+MultiWindowCapture::~MultiWindowCapture() {
+}
+
+void MultiWindowCapture::CaptureWindows() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+
+  std::vector<content::RenderViewHost*> hosts;
+  std::vector<Shell*>& windows = Shell::windows();
+  for (size_t i = 0; i < windows.size(); ++i) {
+    if (windows[i]->is_devtools())
+      continue;
+    content::WebContents* web_contents = windows[i]->web_contents();
+    Entry entry;
+    entry.id = windows[i]->id();
+    entry.url = web_contents->GetURL();
+    entry.title = web_contents->GetTitle();
+    entries_.push_back(entry);
+    // The ones left out get no data right away.
+    hosts.push_back(IsCapturable(windows[i]) ?
+        web_contents->GetRenderViewHost() : NULL);
+  }
+
+  // One extra count keeps the reply from going out before every request
+  // has been issued.
+  pending_ = hosts.size() + 1;
+  for (size_t i = 0; i < hosts.size(); ++i) {
+    content::RenderWidgetHostView* view =
+        hosts[i] ? hosts[i]->GetView() : NULL;
+    if (!view) {
+      OnWindowDone();
+      continue;
+    }
+    hosts[i]->CopyFromBackingStore(
+        gfx::Rect(),
+        view->GetViewBounds().size(),
+        base::Bind(&MultiWindowCapture::OnCopied, this, i));
+  }
+
+  MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&MultiWindowCapture::OnTimeout, this),
+      base::TimeDelta::FromSeconds(kCaptureTimeoutSeconds));
+  OnWindowDone();
+}
+
+void MultiWindowCapture::OnCopied(size_t index,
+                                  bool succeeded,
+                                  const SkBitmap& bitmap) {
+  if (finished_)
+    return;
+  if (!succeeded) {
+    VLOG(1) << "Reading the backing store of window " << entries_[index].id
+            << " failed.";
+    OnWindowDone();
+    return;
+  }
+
+  // The backing store bitmap may not own its pixels, so hand the worker a
+  // private copy.
+  SkBitmap* copy = new SkBitmap;
+  if (!bitmap.copyTo(copy, SkBitmap::kARGB_8888_Config)) {
+    delete copy;
+    OnWindowDone();
+    return;
+  }
+
+  std::string* data_url = new std::string;
+  base::WorkerPool::PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&EncodeOnWorker, options_, base::Owned(copy), data_url),
+      base::Bind(&MultiWindowCapture::OnEncoded, this, index,
+                 base::Owned(data_url)),
+      true);
+}
+
+void MultiWindowCapture::OnEncoded(size_t index, std::string* data_url) {
+  if (finished_)
+    return;
+  entries_[index].data_url.swap(*data_url);
+  OnWindowDone();
+}
+
+void MultiWindowCapture::OnWindowDone() {
+  DCHECK_GT(pending_, 0u);
+  if (--pending_ > 0)
+    return;
+  Finish();
+}
+
+void MultiWindowCapture::OnTimeout() {
+  if (finished_)
+    return;
+  VLOG(1) << pending_ << " windows did not answer in time.";
+  Finish();
+}
+
+void MultiWindowCapture::Finish() {
+  if (finished_)
+    return;
+  finished_ = true;
+
+  base::ListValue windows;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    base::DictionaryValue* window = new base::DictionaryValue;
+    window->SetInteger("id", entries_[i].id);
+    window->SetString("url", entries_[i].url.spec());
+    window->SetString("title", entries_[i].title);
+    if (entries_[i].data_url.empty())
+      window->Set("data", base::Value::CreateNullValue());
+    else
+      window->SetString("data", entries_[i].data_url);
+    windows.Append(window);
+  }
+  callback_.Run(windows);
+}
+
+}  // namespace nw
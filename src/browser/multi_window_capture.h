@@ -0,0 +1,97 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_BROWSER_MULTI_WINDOW_CAPTURE_H_
+#define CONTENT_NW_SRC_BROWSER_MULTI_WINDOW_CAPTURE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/string16.h"
+#include "content/nw/src/browser/capture_page_helper.h"
+#include "googleurl/src/gurl.h"
+
+namespace base {
+class ListValue;
+}
+
+class SkBitmap;
+
+namespace nw {
+
+// Captures every browser window at once. The backing stores of all windows
+// are read back together and each one is encoded on the worker pool as soon
+// as it arrives, so the encoders run side by side instead of one window
+// after the other. |callback| gets a list with one entry per window:
+//   { id, url, title, data }
+// where |data| is a "data:" URL, or null if the window had nothing to
+// capture. A window that is hidden or closes before its backing store
+// arrives never answers; after a timeout the list is sent with null for
+// every window still outstanding.
+class MultiWindowCapture
+    : public base::RefCountedThreadSafe<MultiWindowCapture> {
+ public:
+  typedef base::Callback<void(const base::ListValue&)> CompletionCallback;
+
+  // Only data URLs are produced, |options.data_type| is ignored.
+  static void Start(const CapturePageHelper::Options& options,
+                    const CompletionCallback& callback);
+
+ private:
+  struct Entry {
+    Entry();
+
+    int id;
+    GURL url;
+    string16 title;
+    std::string data_url;
+  };
+
+  MultiWindowCapture(const CapturePageHelper::Options& options,
+                     const CompletionCallback& callback);
+  ~MultiWindowCapture();
+
+  void CaptureWindows();
+  void OnCopied(size_t index, bool succeeded, const SkBitmap& bitmap);
+  void OnEncoded(size_t index, std::string* data_url);
+
+  // Counts down |pending_| and replies once every window is done.
+  void OnWindowDone();
+
+  // Replies with whatever has arrived so far.
+  void OnTimeout();
+  void Finish();
+
+  CapturePageHelper::Options options_;
+  CompletionCallback callback_;
+  std::vector<Entry> entries_;
+  size_t pending_;
+  bool finished_;
+
+  friend class base::RefCountedThreadSafe<MultiWindowCapture>;
+
+  DISALLOW_COPY_AND_ASSIGN(MultiWindowCapture);
+};
+
+}  // namespace nw
+
+#endif  // CONTENT_NW_SRC_BROWSER_MULTI_WINDOW_CAPTURE_H_
@@ -22,6 +22,9 @@
 
 #include "base/values.h"
 #include "content/nw/src/browser/capture_page_helper.h"
+#include "content/nw/src/browser/first_paint_tracker.h"
+#include "content/nw/src/browser/native_window_headless.h"
+#include "content/nw/src/browser/screencast_helper.h"
 #include "content/nw/src/common/shell_switches.h"
 #include "content/nw/src/nw_package.h"
 #include "content/nw/src/nw_shell.h"
@@ -48,6 +51,9 @@ NativeWindow* NativeWindow::Create(content::Shell* shell,
   if (!manifest->HasKey(switches::kmHeight))
     manifest->SetInteger(switches::kmHeight, 450);
 
+  if (NativeWindowHeadless::IsHeadless(manifest))
+    return new NativeWindowHeadless(shell, manifest);
+
   // Create window.
   NativeWindow* window = 
 #if defined(TOOLKIT_GTK)
@@ -68,7 +74,8 @@ NativeWindow::NativeWindow(content::Shell* shell,
                            base::DictionaryValue* manifest)
     : shell_(shell),
       has_frame_(true),
-      capture_page_helper_(NULL) {
+      capture_page_helper_(NULL),
+      screencast_helper_(NULL) {
   manifest->GetBoolean(switches::kmFrame, &has_frame_);
 
   LoadAppIconFromPackage(manifest);
@@ -132,19 +139,37 @@ void NativeWindow::InitFromManifest(base::DictionaryValue* manifest) {
   manifest->GetString(switches::kmTitle, &title);
   SetTitle(title);
 
-  // Then show it.
+  // Then show it, unless it waits for the page to paint.
   bool show = true;
   manifest->GetBoolean(switches::kmShow, &show);
-  if (show)
+  if (show && !shell_->first_paint_tracker()->DeferShow())
     Show();
 }
 
-void NativeWindow::CapturePage(const std::string& image_format) {
+void NativeWindow::CapturePage(const base::DictionaryValue& options) {
   // Lazily instance CapturePageHelper.
   if (capture_page_helper_ == NULL)
     capture_page_helper_ = CapturePageHelper::Create(shell_);
 
-  capture_page_helper_->StartCapturePage(image_format);
+  capture_page_helper_->StartCapturePage(options);
+}
+
+void NativeWindow::StartScreencast(const base::DictionaryValue& options) {
+  // Lazily instance ScreencastHelper.
+  if (screencast_helper_ == NULL)
+    screencast_helper_ = ScreencastHelper::Create(shell_);
+
+  screencast_helper_->Start(options);
+}
+
+void NativeWindow::StopScreencast() {
+  if (screencast_helper_)
+    screencast_helper_->Stop();
+}
+
+void NativeWindow::AckScreencastFrame(int sequence) {
+  if (screencast_helper_)
+    screencast_helper_->AckFrame(sequence);
 }
 
 void NativeWindow::LoadAppIconFromPackage(base::DictionaryValue* manifest) {
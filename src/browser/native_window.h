@@ -57,6 +57,7 @@ class Rect;
 namespace nw {
 
 class CapturePageHelper;
+class ScreencastHelper;
 
 class NativeWindow {
  public:
@@ -93,6 +94,9 @@ class NativeWindow {
   virtual bool IsKiosk() = 0;
   virtual void SetMenu(api::Menu* menu) = 0;
 
+  // Whether the window is never put on screen.
+  virtual bool IsHeadless() const { return false; }
+
   // Toolbar related controls.
   enum TOOLBAR_BUTTON {
     BUTTON_BACK = 0,
@@ -116,7 +120,10 @@ class NativeWindow {
   content::WebContents* web_contents() const;
   bool has_frame() const { return has_frame_; }
   const gfx::Image& app_icon() const { return app_icon_; }
-  void CapturePage(const std::string& image_format);
+  void CapturePage(const base::DictionaryValue& options);
+  void StartScreencast(const base::DictionaryValue& options);
+  void StopScreencast();
+  void AckScreencastFrame(int sequence);
 
  protected:
   explicit NativeWindow(content::Shell* shell,
@@ -131,6 +138,7 @@ class NativeWindow {
   gfx::Image app_icon_;
 
   scoped_refptr<CapturePageHelper> capture_page_helper_;
+  scoped_refptr<ScreencastHelper> screencast_helper_;
 
  private:
   void LoadAppIconFromPackage(base::DictionaryValue* manifest);
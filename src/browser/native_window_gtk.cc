@@ -26,6 +26,7 @@
 #include "chrome/browser/ui/gtk/gtk_window_util.h"
 #include "extensions/common/draggable_region.h"
 #include "content/nw/src/api/menu/menu.h"
+#include "content/nw/src/browser/window_throttler.h"
 #include "content/nw/src/common/shell_switches.h"
 #include "content/nw/src/nw_shell.h"
 #include "content/public/browser/render_view_host.h"
@@ -115,6 +116,9 @@ NativeWindowGtk::NativeWindowGtk(content::Shell* shell,
                    G_CALLBACK(OnFocusOutThunk), this);
   g_signal_connect(window_, "window-state-event",
                    G_CALLBACK(OnWindowStateThunk), this);
+  gtk_widget_add_events(GTK_WIDGET(window_), GDK_VISIBILITY_NOTIFY_MASK);
+  g_signal_connect(window_, "visibility-notify-event",
+                   G_CALLBACK(OnVisibilityNotifyThunk), this);
   g_signal_connect(window_, "delete-event",
                    G_CALLBACK(OnWindowDeleteEventThunk), this);
   if (!has_frame_) {
@@ -491,11 +495,22 @@ gboolean NativeWindowGtk::OnFocusOut(GtkWidget* window, GdkEventFocus*) {
   return FALSE;
 }
 
+// Window got covered or uncovered by other windows. Compositing window
+// managers always report it as unobscured.
+gboolean NativeWindowGtk::OnVisibilityNotify(GtkWidget* window,
+                                             GdkEventVisibility* event) {
+  shell()->window_throttler()->SetOccluded(
+      event->state == GDK_VISIBILITY_FULLY_OBSCURED);
+  return FALSE;
+}
+
 // Window state has changed.
 gboolean NativeWindowGtk::OnWindowState(GtkWidget* window,
                                         GdkEventWindowState* event) {
   switch (event->changed_mask) {
     case GDK_WINDOW_STATE_ICONIFIED:
+      shell()->window_throttler()->SetMinimized(
+          (event->new_window_state & GDK_WINDOW_STATE_ICONIFIED) != 0);
       if (event->new_window_state & GDK_WINDOW_STATE_ICONIFIED)
         shell()->SendEvent("minimize");
       else
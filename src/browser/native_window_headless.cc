@@ -0,0 +1,210 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/native_window_headless.h"
+
+#include <algorithm>
+
+#include "base/command_line.h"
+#include "base/message_loop.h"
+#include "base/values.h"
+#include "content/nw/src/browser/window_throttler.h"
+#include "content/nw/src/common/shell_switches.h"
+#include "content/nw/src/nw_shell.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/browser/web_contents_view.h"
+
+namespace nw {
+
+// static
+bool NativeWindowHeadless::IsHeadless(base::DictionaryValue* manifest) {
+  if (CommandLine::ForCurrentProcess()->HasSwitch(switches::kHeadless))
+    return true;
+  bool headless = false;
+  return manifest->GetBoolean(switches::kmHeadless, &headless) && headless;
+}
+
+NativeWindowHeadless::NativeWindowHeadless(content::Shell* shell,
+                                           base::DictionaryValue* manifest)
+    : NativeWindow(shell, manifest),
+      is_fullscreen_(false),
+      is_kiosk_(false),
+      is_closing_(false) {
+  int width = 0, height = 0;
+  manifest->GetInteger(switches::kmWidth, &width);
+  manifest->GetInteger(switches::kmHeight, &height);
+  bounds_.set_size(gfx::Size(width, height));
+  UpdateContentsSize();
+}
+
+NativeWindowHeadless::~NativeWindowHeadless() {
+}
+
+void NativeWindowHeadless::Close() {
+  if (is_closing_ || !shell_->ShouldCloseWindow())
+    return;
+
+  // There is no toplevel whose destruction would delete the shell, and
+  // Close() may be called from inside a WebContents callback.
+  is_closing_ = true;
+  MessageLoop::current()->DeleteSoon(FROM_HERE, shell_);
+}
+
+void NativeWindowHeadless::Move(const gfx::Rect& pos) {
+  bounds_ = pos;
+  UpdateContentsSize();
+}
+
+void NativeWindowHeadless::Focus(bool focus) {
+}
+
+void NativeWindowHeadless::Show() {
+}
+
+void NativeWindowHeadless::Hide() {
+}
+
+void NativeWindowHeadless::Maximize() {
+  shell()->SendEvent("maximize");
+}
+
+void NativeWindowHeadless::Unmaximize() {
+  shell()->SendEvent("unmaximize");
+}
+
+void NativeWindowHeadless::Minimize() {
+  shell()->window_throttler()->SetMinimized(true);
+  shell()->SendEvent("minimize");
+}
+
+void NativeWindowHeadless::Restore() {
+  shell()->window_throttler()->SetMinimized(false);
+  shell()->SendEvent("restore");
+}
+
+void NativeWindowHeadless::SetFullscreen(bool fullscreen) {
+  if (is_fullscreen_ == fullscreen)
+    return;
+  is_fullscreen_ = fullscreen;
+  shell()->SendEvent(fullscreen ? "enter-fullscreen" : "leave-fullscreen");
+}
+
+bool NativeWindowHeadless::IsFullscreen() {
+  return is_fullscreen_;
+}
+
+void NativeWindowHeadless::SetSize(const gfx::Size& size) {
+  bounds_.set_size(size);
+  UpdateContentsSize();
+}
+
+gfx::Size NativeWindowHeadless::GetSize() {
+  return bounds_.size();
+}
+
+void NativeWindowHeadless::SetMinimumSize(int width, int height) {
+  minimum_size_.SetSize(width, height);
+  UpdateContentsSize();
+}
+
+void NativeWindowHeadless::SetMaximumSize(int width, int height) {
+  maximum_size_.SetSize(width, height);
+  UpdateContentsSize();
+}
+
+void NativeWindowHeadless::SetResizable(bool resizable) {
+}
+
+void NativeWindowHeadless::SetAlwaysOnTop(bool top) {
+}
+
+void NativeWindowHeadless::SetPosition(const std::string& position) {
+  // There is no screen to center on.
+}
+
+void NativeWindowHeadless::SetPosition(const gfx::Point& position) {
+  bounds_.set_origin(position);
+}
+
+gfx::Point NativeWindowHeadless::GetPosition() {
+  return bounds_.origin();
+}
+
+void NativeWindowHeadless::SetTitle(const std::string& title) {
+  title_ = title;
+}
+
+void NativeWindowHeadless::FlashFrame(bool flash) {
+}
+
+void NativeWindowHeadless::SetKiosk(bool kiosk) {
+  is_kiosk_ = kiosk;
+}
+
+bool NativeWindowHeadless::IsKiosk() {
+  return is_kiosk_;
+}
+
+void NativeWindowHeadless::SetMenu(api::Menu* menu) {
+}
+
+bool NativeWindowHeadless::IsHeadless() const {
+  return true;
+}
+
+void NativeWindowHeadless::SetToolbarButtonEnabled(TOOLBAR_BUTTON button,
+                                                   bool enabled) {
+}
+
+void NativeWindowHeadless::SetToolbarUrlEntry(const std::string& url) {
+}
+
+void NativeWindowHeadless::SetToolbarIsLoading(bool loading) {
+}
+
+void NativeWindowHeadless::AddToolbar() {
+}
+
+void NativeWindowHeadless::UpdateDraggableRegions(
+    const std::vector<extensions::DraggableRegion>& regions) {
+}
+
+void NativeWindowHeadless::HandleKeyboardEvent(
+    const content::NativeWebKeyboardEvent& event) {
+}
+
+void NativeWindowHeadless::UpdateContentsSize() {
+  gfx::Size size = bounds_.size();
+  if (minimum_size_.width() > 0)
+    size.set_width(std::max(size.width(), minimum_size_.width()));
+  if (minimum_size_.height() > 0)
+    size.set_height(std::max(size.height(), minimum_size_.height()));
+  if (maximum_size_.width() > 0)
+    size.set_width(std::min(size.width(), maximum_size_.width()));
+  if (maximum_size_.height() > 0)
+    size.set_height(std::min(size.height(), maximum_size_.height()));
+  bounds_.set_size(size);
+
+  // The view is never allocated by a toolkit, so tell the renderer the size
+  // directly.
+  web_contents()->GetView()->SizeContents(size);
+}
+
+}  // namespace nw
@@ -30,6 +30,7 @@
 #include "content/nw/src/browser/native_window_helper_mac.h"
 #include "content/nw/src/browser/shell_toolbar_delegate_mac.h"
 #include "content/nw/src/browser/standard_menus_mac.h"
+#include "content/nw/src/browser/window_throttler.h"
 #include "content/nw/src/common/shell_switches.h"
 #include "content/nw/src/nw_package.h"
 #include "content/nw/src/nw_shell.h"
@@ -123,10 +124,12 @@ enum {
 }
 
 - (void)windowDidMiniaturize:(NSNotification *)notification{
+  shell_->window_throttler()->SetMinimized(true);
   shell_->SendEvent("minimize");
 }
 
 - (void)windowDidDeminiaturize:(NSNotification *)notification {
+  shell_->window_throttler()->SetMinimized(false);
   shell_->SendEvent("restore");
 }
 
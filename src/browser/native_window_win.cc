@@ -26,6 +26,7 @@
 #include "chrome/browser/platform_util.h"
 #include "content/nw/src/api/menu/menu.h"
 #include "content/nw/src/browser/native_window_toolbar_win.h"
+#include "content/nw/src/browser/window_throttler.h"
 #include "content/nw/src/common/shell_switches.h"
 #include "content/nw/src/nw_shell.h"
 #include "content/public/browser/native_web_keyboard_event.h"
@@ -592,9 +593,11 @@ bool NativeWindowWin::ExecuteWindowsCommand(int command_id) {
 
   if ((command_id & sc_mask) == SC_MINIMIZE) {
     is_minimized_ = true;
+    shell()->window_throttler()->SetMinimized(true);
     shell()->SendEvent("minimize");
   } else if ((command_id & sc_mask) == SC_RESTORE && is_minimized_) {
     is_minimized_ = false;
+    shell()->window_throttler()->SetMinimized(false);
     shell()->SendEvent("restore");
   } else if ((command_id & sc_mask) == SC_RESTORE && !is_minimized_) {
     shell()->SendEvent("unmaximize");
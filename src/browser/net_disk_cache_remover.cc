@@ -4,84 +4,212 @@
 
 #include "net_disk_cache_remover.h"
 
-#include "base/bind_helpers.h"
-#include "base/synchronization/waitable_event.h"
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
-#include "content/public/browser/web_contents.h"
+#include "net/base/completion_callback.h"
+#include "net/base/net_errors.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/http/http_cache.h"
 #include "net/http/http_transaction_factory.h"
 #include "net/url_request/url_request_context_getter.h"
 #include "net/url_request/url_request_context.h"
-#include "net/base/completion_callback.h"
 
 using content::BrowserThread;
 using disk_cache::Backend;
-using net::CompletionCallback;
 using net::URLRequestContextGetter;
 
+namespace nw {
+
 namespace {
-// Everything is called and accessed on the IO thread.
 
-void Noop(base::WaitableEvent* completion, int rv) {
-  DCHECK(rv == net::OK);
-  if (completion)
-    completion->Signal();
-}
+// Dooms the selected entries of a list of request contexts, one context after
+// the other. Created on the UI thread, does all of its work on the IO thread
+// and reports back on the UI thread. Keeps itself alive through the callbacks
+// it hands to the cache.
+class HttpDiskCacheRemover
+    : public base::RefCountedThreadSafe<HttpDiskCacheRemover> {
+ public:
+  typedef std::vector<scoped_refptr<URLRequestContextGetter> > GetterList;
 
-void CallDoomAllEntries(Backend** backend, base::WaitableEvent* completion, int rv) {
-  DCHECK(rv == net::OK);
-  (*backend)->DoomAllEntries(base::Bind(&Noop, completion));
-}
+  HttpDiskCacheRemover(const GetterList& getters,
+                       const HttpDiskCacheRemoveOptions& options,
+                       const base::Closure& done)
+      : getters_(getters),
+        options_(options),
+        done_(done),
+        current_(0),
+        backend_(NULL),
+        iter_(NULL),
+        entry_(NULL) {
+  }
 
-void ClearHttpDiskCacheOfContext(URLRequestContextGetter* context_getter,
-                                 base::WaitableEvent* completion) {
-  typedef Backend* BackendPtr;  // Make line below easier to understand.
-  BackendPtr* backend_ptr = new BackendPtr(NULL);
-  CompletionCallback callback(base::Bind(&CallDoomAllEntries,
-                                         base::Owned(backend_ptr),
-                                         completion));
-
-  int rv = context_getter->GetURLRequestContext()->
-    http_transaction_factory()->GetCache()->GetBackend(backend_ptr, callback);
-
-  // If not net::ERR_IO_PENDING, then backend pointer is updated but callback
-  // is not called, so call it explicitly.
-  if (rv != net::ERR_IO_PENDING)
-    callback.Run(net::OK);
-}
+  void Start() {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&HttpDiskCacheRemover::ClearNextContext, this));
+  }
 
-void ClearHttpDiskCacheOnIoThread(
-    URLRequestContextGetter* main_context_getter,
-    URLRequestContextGetter* media_context_getter,
-    base::WaitableEvent* completion1,
-    base::WaitableEvent* completion2) {
-  ClearHttpDiskCacheOfContext(main_context_getter, completion1);
-  ClearHttpDiskCacheOfContext(media_context_getter, completion2);
-}
+ private:
+  friend class base::RefCountedThreadSafe<HttpDiskCacheRemover>;
+
+  ~HttpDiskCacheRemover() {
+    DCHECK(!entry_);
+  }
+
+  void ClearNextContext() {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+    if (current_ >= getters_.size()) {
+      BrowserThread::PostTask(
+          BrowserThread::UI, FROM_HERE,
+          base::Bind(&HttpDiskCacheRemover::NotifyDone, this));
+      return;
+    }
+
+    net::HttpCache* cache = getters_[current_]->GetURLRequestContext()->
+        http_transaction_factory()->GetCache();
+    if (!cache) {
+      OnContextCleared(net::OK);
+      return;
+    }
+
+    net::CompletionCallback callback(
+        base::Bind(&HttpDiskCacheRemover::OnGotBackend, this));
+    int rv = cache->GetBackend(&backend_, callback);
+    // If not net::ERR_IO_PENDING, then backend pointer is updated but callback
+    // is not called, so call it explicitly.
+    if (rv != net::ERR_IO_PENDING)
+      callback.Run(rv);
+  }
+
+  void OnGotBackend(int rv) {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+    if (rv != net::OK || !backend_) {
+      OnContextCleared(rv);
+      return;
+    }
+
+    if (!options_.origins.empty()) {
+      DoomNextMatchingEntry();
+      return;
+    }
+
+    net::CompletionCallback callback(
+        base::Bind(&HttpDiskCacheRemover::OnContextCleared, this));
+    if (options_.delete_begin.is_null() && options_.delete_end.is_max())
+      rv = backend_->DoomAllEntries(callback);
+    else
+      rv = backend_->DoomEntriesBetween(options_.delete_begin,
+                                        options_.delete_end, callback);
+    if (rv != net::ERR_IO_PENDING)
+      callback.Run(rv);
+  }
+
+  // Walks the cache and dooms the entries of |options_.origins| that fall in
+  // the time range. Entries that are returned synchronously are handled in the
+  // loop so a large cache does not recurse.
+  void DoomNextMatchingEntry() {
+    for (;;) {
+      int rv = backend_->OpenNextEntry(
+          &iter_, &entry_,
+          base::Bind(&HttpDiskCacheRemover::OnEntryOpened, this));
+      if (rv == net::ERR_IO_PENDING || !HandleOpenedEntry(rv))
+        return;
+    }
+  }
+
+  void OnEntryOpened(int rv) {
+    if (HandleOpenedEntry(rv))
+      DoomNextMatchingEntry();
+  }
+
+  // Returns false once the enumeration is finished.
+  bool HandleOpenedEntry(int rv) {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+    if (rv != net::OK) {
+      backend_->EndEnumeration(&iter_);
+      iter_ = NULL;
+      OnContextCleared(net::OK);
+      return false;
+    }
+
+    base::Time last_used = entry_->GetLastUsed();
+    if (options_.origins.count(GURL(entry_->GetKey()).GetOrigin()) &&
+        last_used >= options_.delete_begin &&
+        last_used < options_.delete_end) {
+      entry_->Doom();
+    }
+    entry_->Close();
+    entry_ = NULL;
+    return true;
+  }
+
+  void OnContextCleared(int rv) {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+    DLOG_IF(WARNING, rv != net::OK) << "Failed to clear http cache: " << rv;
+    backend_ = NULL;
+    ++current_;
+    ClearNextContext();
+  }
+
+  void NotifyDone() {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+    if (!done_.is_null())
+      done_.Run();
+  }
+
+  GetterList getters_;
+  HttpDiskCacheRemoveOptions options_;
+  base::Closure done_;
+
+  // Everything below is only accessed on the IO thread.
+  size_t current_;
+  Backend* backend_;
+  void* iter_;
+  disk_cache::Entry* entry_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpDiskCacheRemover);
+};
 
 }  // namespace
 
-namespace nw {
+HttpDiskCacheRemoveOptions::HttpDiskCacheRemoveOptions()
+    : delete_end(base::Time::Max()) {
+}
+
+HttpDiskCacheRemoveOptions::~HttpDiskCacheRemoveOptions() {
+}
 
 void RemoveHttpDiskCache(content::BrowserContext* browser_context,
-                        int renderer_child_id) {
-  URLRequestContextGetter* main_context_getter =
-      browser_context->GetRequestContextForRenderProcess(renderer_child_id);
-  URLRequestContextGetter* media_context_getter =
+                         int renderer_child_id,
+                         const HttpDiskCacheRemoveOptions& options,
+                         const base::Closure& done) {
+  URLRequestContextGetter* candidates[] = {
+      browser_context->GetRequestContextForRenderProcess(renderer_child_id),
       browser_context->GetMediaRequestContextForRenderProcess(
-          renderer_child_id);
-
-  base::WaitableEvent comp1(false, false), comp2(false, false);
-  BrowserThread::PostTask(
-      BrowserThread::IO, FROM_HERE,
-      base::Bind(&ClearHttpDiskCacheOnIoThread,
-                 base::Unretained(main_context_getter),
-                 base::Unretained(media_context_getter),
-                 &comp1, &comp2));
-  comp1.Wait();
-  comp2.Wait();
+          renderer_child_id),
+  };
+
+  // The media getter usually hands back the main context; don't doom the same
+  // cache twice.
+  HttpDiskCacheRemover::GetterList getters;
+  for (size_t i = 0; i < arraysize(candidates); ++i) {
+    if (candidates[i] &&
+        std::find(getters.begin(), getters.end(), candidates[i]) ==
+            getters.end()) {
+      getters.push_back(candidates[i]);
+    }
+  }
+
+  scoped_refptr<HttpDiskCacheRemover> remover(
+      new HttpDiskCacheRemover(getters, options, done));
+  remover->Start();
 }
 
 }  // namespace nw
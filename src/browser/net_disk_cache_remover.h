@@ -5,6 +5,12 @@
 #ifndef NW_BROWSER_NET_DISK_CACHE_REMOVER_H_
 #define NW_BROWSER_NET_DISK_CACHE_REMOVER_H_
 
+#include <set>
+
+#include "base/callback_forward.h"
+#include "base/time.h"
+#include "googleurl/src/gurl.h"
+
 namespace content {
 
 class BrowserContext;
@@ -13,10 +19,30 @@ class BrowserContext;
 
 namespace nw {
 
-// Clear all http disk cache for this renderer. This method is asynchronous and
-// will noop if a previous call has not finished.
+// Selects which http disk cache entries RemoveHttpDiskCache() dooms.
+struct HttpDiskCacheRemoveOptions {
+  HttpDiskCacheRemoveOptions();
+  ~HttpDiskCacheRemoveOptions();
+
+  // Only entries last used in [delete_begin, delete_end) are doomed. The
+  // defaults cover all entries.
+  base::Time delete_begin;
+  base::Time delete_end;
+
+  // If not empty, only entries whose URL belongs to one of these origins are
+  // doomed. This requires enumerating the cache, so it is slower than a pure
+  // time range.
+  std::set<GURL> origins;
+};
+
+// Clear the http disk cache for this renderer. This method is asynchronous:
+// the cache is doomed on the IO thread and |done| is run on the UI thread.
+// Request contexts shared between the main and the media getters are only
+// cleared once. |done| may be null.
 void RemoveHttpDiskCache(content::BrowserContext* browser_context,
-                        int renderer_child_id);
+                         int renderer_child_id,
+                         const HttpDiskCacheRemoveOptions& options,
+                         const base::Closure& done);
 
 }  // namespace nw
 
@@ -0,0 +1,428 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy 
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/parallel_png_encoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/worker_pool.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkUnPreMultiply.h"
+#include "third_party/zlib/zlib.h"
+
+namespace nw {
+
+namespace {
+
+// Stripes smaller than this do not pay back the cost of a worker thread and
+// of the extra sync flush marker.
+const int kMinRowsPerStripe = 64;
+
+const int kBytesPerPixel = 3;  // RGB, 8 bits per channel.
+
+enum PNGFilter {
+  FILTER_NONE = 0,
+  FILTER_SUB = 1,
+  FILTER_UP = 2,
+  FILTER_PAETH = 4
+};
+
+struct Stripe {
+  Stripe() : begin_row(0), end_row(0), adler(0), raw_size(0), ok(false) {}
+
+  int begin_row;
+  int end_row;
+  std::vector<unsigned char> compressed;
+  uLong adler;
+  uLong raw_size;
+  bool ok;
+};
+
+void ConvertRow(const SkBitmap& bitmap, int y, unsigned char* rgb) {
+  const SkPMColor* src = bitmap.getAddr32(0, y);
+  for (int x = 0; x < bitmap.width(); ++x) {
+    SkColor color = SkUnPreMultiply::PMColorToColor(src[x]);
+    rgb[x * kBytesPerPixel + 0] = SkColorGetR(color);
+    rgb[x * kBytesPerPixel + 1] = SkColorGetG(color);
+    rgb[x * kBytesPerPixel + 2] = SkColorGetB(color);
+  }
+}
+
+unsigned char Paeth(int a, int b, int c) {
+  int p = a + b - c;
+  int pa = std::abs(p - a);
+  int pb = std::abs(p - b);
+  int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc)
+    return a;
+  return pb <= pc ? b : c;
+}
+
+// Applies |filter| to |row| and returns the sum of the absolute values of
+// the signed result, the usual heuristic for picking a filter per row.
+uint32 FilterRow(PNGFilter filter,
+                 const unsigned char* row,
+                 const unsigned char* prior,
+                 size_t row_size,
+                 unsigned char* out) {
+  uint32 sum = 0;
+  for (size_t i = 0; i < row_size; ++i) {
+    int left = i >= kBytesPerPixel ? row[i - kBytesPerPixel] : 0;
+    int up = prior ? prior[i] : 0;
+    int up_left = (prior && i >= kBytesPerPixel) ?
+        prior[i - kBytesPerPixel] : 0;
+    unsigned char value = row[i];
+    switch (filter) {
+      case FILTER_NONE:
+        break;
+      case FILTER_SUB:
+        value -= left;
+        break;
+      case FILTER_UP:
+        value -= up;
+        break;
+      case FILTER_PAETH:
+        value -= Paeth(left, up, up_left);
+        break;
+    }
+    out[i] = value;
+    sum += value < 128 ? value : 256 - value;
+  }
+  return sum;
+}
+
+// Picks the filter with the smallest sum for |row| and writes the filter
+// type followed by the filtered bytes to |best|, which holds |row_size| + 1
+// bytes. |candidate| is scratch space of |row_size| bytes.
+void FilterRowAdaptive(const unsigned char* row,
+                       const unsigned char* prior,
+                       size_t row_size,
+                       unsigned char* candidate,
+                       unsigned char* best) {
+  const PNGFilter kFilters[] = {
+    FILTER_NONE, FILTER_SUB, FILTER_UP, FILTER_PAETH
+  };
+  uint32 best_sum = kuint32max;
+  for (size_t i = 0; i < arraysize(kFilters); ++i) {
+    uint32 sum = FilterRow(kFilters[i], row, prior, row_size, candidate);
+    if (sum < best_sum) {
+      best_sum = sum;
+      best[0] = kFilters[i];
+      std::copy(candidate, candidate + row_size, best + 1);
+    }
+  }
+}
+
+// Filters and raw-deflates the rows of |stripe|. Every stripe but the last
+// ends on a byte boundary with an empty stored block so the pieces can be
+// concatenated into one valid deflate stream.
+void EncodeStripe(const SkBitmap* bitmap,
+                  int compression_level,
+                  bool last,
+                  Stripe* stripe,
+                  base::WaitableEvent* done) {
+  const size_t row_size = bitmap->width() * kBytesPerPixel;
+  std::vector<unsigned char> prior(row_size);
+  std::vector<unsigned char> current(row_size);
+  std::vector<unsigned char> best(row_size + 1);
+  std::vector<unsigned char> candidate(row_size);
+
+  bool has_prior = stripe->begin_row > 0;
+  if (has_prior)
+    ConvertRow(*bitmap, stripe->begin_row - 1, &prior[0]);
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (deflateInit2(&stream, compression_level, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    if (done)
+      done->Signal();
+    return;
+  }
+
+  const uLong raw_size = (row_size + 1) *
+      (stripe->end_row - stripe->begin_row);
+  stripe->compressed.resize(deflateBound(&stream, raw_size) + 16);
+  stream.next_out = &stripe->compressed[0];
+  stream.avail_out = stripe->compressed.size();
+
+  uLong adler = adler32(0L, Z_NULL, 0);
+  bool ok = true;
+  for (int y = stripe->begin_row; ok && y < stripe->end_row; ++y) {
+    ConvertRow(*bitmap, y, &current[0]);
+    FilterRowAdaptive(&current[0], has_prior ? &prior[0] : NULL, row_size,
+                      &candidate[0], &best[0]);
+
+    adler = adler32(adler, &best[0], best.size());
+    stream.next_in = &best[0];
+    stream.avail_in = best.size();
+    bool last_row = y == stripe->end_row - 1;
+    int flush = !last_row ? Z_NO_FLUSH : (last ? Z_FINISH : Z_SYNC_FLUSH);
+    int result = deflate(&stream, flush);
+    ok = (result == Z_OK || result == Z_STREAM_END) && stream.avail_in == 0;
+
+    current.swap(prior);
+    has_prior = true;
+  }
+
+  stripe->compressed.resize(stream.total_out);
+  stripe->adler = adler;
+  stripe->raw_size = raw_size;
+  stripe->ok = ok;
+  deflateEnd(&stream);
+
+  if (done)
+    done->Signal();
+}
+
+void AppendUint32(uint32 value, std::vector<unsigned char>* output) {
+  output->push_back((value >> 24) & 0xff);
+  output->push_back((value >> 16) & 0xff);
+  output->push_back((value >> 8) & 0xff);
+  output->push_back(value & 0xff);
+}
+
+void AppendChunk(const char type[4],
+                 const unsigned char* data,
+                 size_t size,
+                 std::vector<unsigned char>* output) {
+  AppendUint32(size, output);
+  const unsigned char* type_bytes = reinterpret_cast<const unsigned char*>(type);
+  output->insert(output->end(), type_bytes, type_bytes + 4);
+  uLong crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc, type_bytes, 4);
+  if (size) {
+    output->insert(output->end(), data, data + size);
+    crc = crc32(crc, data, size);
+  }
+  AppendUint32(crc, output);
+}
+
+// Writes the PNG signature and the IHDR chunk of an 8-bit RGB image.
+void AppendSignatureAndHeader(int width,
+                              int height,
+                              std::vector<unsigned char>* output) {
+  static const unsigned char kSignature[] = {
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
+  };
+  output->insert(output->end(), kSignature,
+                 kSignature + arraysize(kSignature));
+
+  std::vector<unsigned char> header;
+  AppendUint32(width, &header);
+  AppendUint32(height, &header);
+  header.push_back(8);  // Bit depth.
+  header.push_back(2);  // Color type: truecolor.
+  header.push_back(0);  // Compression method.
+  header.push_back(0);  // Filter method.
+  header.push_back(0);  // Interlace method.
+  AppendChunk("IHDR", &header[0], header.size(), output);
+}
+
+}  // namespace
+
+bool EncodePNGInStripes(const SkBitmap& bitmap,
+                        int compression_level,
+                        std::vector<unsigned char>* output) {
+  DCHECK_EQ(bitmap.config(), SkBitmap::kARGB_8888_Config);
+  if (bitmap.width() <= 0 || bitmap.height() <= 0)
+    return false;
+  compression_level = std::max(0, std::min(compression_level, 9));
+
+  SkAutoLockPixels bitmap_lock(bitmap);
+
+  int stripe_count = std::min(base::SysInfo::NumberOfProcessors(),
+                              bitmap.height() / kMinRowsPerStripe);
+  stripe_count = std::max(stripe_count, 1);
+  const int rows_per_stripe =
+      (bitmap.height() + stripe_count - 1) / stripe_count;
+
+  ScopedVector<Stripe> stripes;
+  ScopedVector<base::WaitableEvent> events;
+  for (int i = 0; i < stripe_count; ++i) {
+    Stripe* stripe = new Stripe;
+    stripe->begin_row = i * rows_per_stripe;
+    stripe->end_row = std::min(bitmap.height(),
+                               stripe->begin_row + rows_per_stripe);
+    stripes.push_back(stripe);
+  }
+
+  // Stripe 0 is done on the calling thread, the rest on the worker pool.
+  for (size_t i = 1; i < stripes.size(); ++i) {
+    base::WaitableEvent* event = new base::WaitableEvent(true, false);
+    events.push_back(event);
+    base::WorkerPool::PostTask(
+        FROM_HERE,
+        base::Bind(&EncodeStripe, &bitmap, compression_level,
+                   i == stripes.size() - 1, stripes[i], event),
+        true);
+  }
+  EncodeStripe(&bitmap, compression_level, stripes.size() == 1, stripes[0],
+               NULL);
+  for (size_t i = 0; i < events.size(); ++i)
+    events[i]->Wait();
+
+  uLong adler = adler32(0L, Z_NULL, 0);
+  size_t compressed_size = 0;
+  for (size_t i = 0; i < stripes.size(); ++i) {
+    if (!stripes[i]->ok)
+      return false;
+    adler = adler32_combine(adler, stripes[i]->adler, stripes[i]->raw_size);
+    compressed_size += stripes[i]->compressed.size();
+  }
+
+  // zlib header: deflate with a 32K window, FLEVEL matching the level.
+  std::vector<unsigned char> idat;
+  idat.reserve(compressed_size + 6);
+  const unsigned char cmf = 0x78;
+  int flevel = compression_level < 2 ? 0 :
+               compression_level < 6 ? 1 :
+               compression_level == 6 ? 2 : 3;
+  unsigned char flg = flevel << 6;
+  flg += 31 - ((cmf * 256 + flg) % 31);
+  idat.push_back(cmf);
+  idat.push_back(flg);
+  for (size_t i = 0; i < stripes.size(); ++i) {
+    idat.insert(idat.end(), stripes[i]->compressed.begin(),
+                stripes[i]->compressed.end());
+  }
+  AppendUint32(adler, &idat);
+
+  output->clear();
+  AppendSignatureAndHeader(bitmap.width(), bitmap.height(), output);
+  AppendChunk("IDAT", &idat[0], idat.size(), output);
+  AppendChunk("IEND", NULL, 0, output);
+  return true;
+}
+
+PNGStreamEncoder::PNGStreamEncoder()
+    : width_(0),
+      height_(0),
+      rows_written_(0),
+      finished_(false) {
+}
+
+PNGStreamEncoder::~PNGStreamEncoder() {
+  if (stream_)
+    deflateEnd(stream_.get());
+}
+
+bool PNGStreamEncoder::Begin(int width, int height, int compression_level) {
+  DCHECK(!stream_);
+  if (width <= 0 || height <= 0)
+    return false;
+  compression_level = std::max(0, std::min(compression_level, 9));
+
+  stream_.reset(new z_stream);
+  memset(stream_.get(), 0, sizeof(z_stream));
+  if (deflateInit(stream_.get(), compression_level) != Z_OK) {
+    stream_.reset();
+    return false;
+  }
+
+  width_ = width;
+  height_ = height;
+  const size_t row_size = width_ * kBytesPerPixel;
+  prior_row_.clear();
+  current_row_.resize(row_size);
+  candidate_row_.resize(row_size);
+  filtered_row_.resize(row_size + 1);
+  AppendSignatureAndHeader(width_, height_, &output_);
+  return true;
+}
+
+bool PNGStreamEncoder::AppendRows(const SkBitmap& tile) {
+  if (!stream_ || finished_ || tile.width() != width_ ||
+      rows_written_ + tile.height() > height_) {
+    return false;
+  }
+  DCHECK_EQ(tile.config(), SkBitmap::kARGB_8888_Config);
+  SkAutoLockPixels tile_lock(tile);
+
+  const size_t row_size = width_ * kBytesPerPixel;
+  std::vector<unsigned char> compressed;
+  for (int y = 0; y < tile.height(); ++y) {
+    ConvertRow(tile, y, &current_row_[0]);
+    FilterRowAdaptive(&current_row_[0],
+                      prior_row_.empty() ? NULL : &prior_row_[0],
+                      row_size, &candidate_row_[0], &filtered_row_[0]);
+    if (!Deflate(&filtered_row_[0], filtered_row_.size(), Z_NO_FLUSH,
+                 &compressed)) {
+      return false;
+    }
+    prior_row_.swap(current_row_);
+    current_row_.resize(row_size);
+  }
+  rows_written_ += tile.height();
+
+  if (!compressed.empty())
+    AppendChunk("IDAT", &compressed[0], compressed.size(), &output_);
+  return true;
+}
+
+bool PNGStreamEncoder::Finish() {
+  if (!stream_ || finished_ || rows_written_ != height_)
+    return false;
+
+  std::vector<unsigned char> compressed;
+  if (!Deflate(NULL, 0, Z_FINISH, &compressed))
+    return false;
+  if (!compressed.empty())
+    AppendChunk("IDAT", &compressed[0], compressed.size(), &output_);
+  AppendChunk("IEND", NULL, 0, &output_);
+  finished_ = true;
+  return true;
+}
+
+void PNGStreamEncoder::TakeOutput(std::vector<unsigned char>* output) {
+  output->insert(output->end(), output_.begin(), output_.end());
+  output_.clear();
+}
+
+bool PNGStreamEncoder::Deflate(const unsigned char* data,
+                               size_t size,
+                               int flush,
+                               std::vector<unsigned char>* compressed) {
+  unsigned char buffer[16 * 1024];
+  stream_->next_in = const_cast<unsigned char*>(data);
+  stream_->avail_in = size;
+  int result;
+  do {
+    stream_->next_out = buffer;
+    stream_->avail_out = sizeof(buffer);
+    result = deflate(stream_.get(), flush);
+    if (result == Z_STREAM_ERROR)
+      return false;
+    compressed->insert(compressed->end(), buffer,
+                       buffer + sizeof(buffer) - stream_->avail_out);
+  } while (stream_->avail_out == 0 ||
+           (flush == Z_FINISH && result != Z_STREAM_END));
+  return stream_->avail_in == 0;
+}
+
+}  // namespace nw
@@ -0,0 +1,93 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy 
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_BROWSER_PARALLEL_PNG_ENCODER_H_
+#define CONTENT_NW_SRC_BROWSER_PARALLEL_PNG_ENCODER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+
+class SkBitmap;
+struct z_stream_s;
+
+namespace nw {
+
+// Encodes |bitmap| as an opaque RGB PNG into |output|.
+//
+// The rows are split into horizontal stripes that are filtered and deflated
+// independently on the worker pool and then stitched into a single zlib
+// stream, the same way pigz does it. This makes large captures scale with
+// the number of cores at the cost of a slightly bigger file.
+// |compression_level| is a zlib level from 0 (store) to 9 (best).
+//
+// Blocks until every stripe is done, so call it off the UI thread.
+bool EncodePNGInStripes(const SkBitmap& bitmap,
+                        int compression_level,
+                        std::vector<unsigned char>* output);
+
+// Encodes an opaque RGB PNG from horizontal tiles fed top to bottom, so a
+// very tall image never has to exist as one bitmap. Only the previous row
+// and the compressed bytes not yet taken by TakeOutput() are kept around.
+// Not thread safe; use it from one sequence.
+class PNGStreamEncoder {
+ public:
+  PNGStreamEncoder();
+  ~PNGStreamEncoder();
+
+  // Starts a |width| x |height| image. Returns false on bad arguments.
+  bool Begin(int width, int height, int compression_level);
+
+  // Appends the rows of |tile|, which must be |width| pixels wide.
+  bool AppendRows(const SkBitmap& tile);
+
+  // Ends the image. Fails if fewer than |height| rows were appended.
+  bool Finish();
+
+  // Moves the bytes encoded so far to the end of |output|.
+  void TakeOutput(std::vector<unsigned char>* output);
+
+  int rows_written() const { return rows_written_; }
+
+ private:
+  bool Deflate(const unsigned char* data,
+               size_t size,
+               int flush,
+               std::vector<unsigned char>* compressed);
+
+  scoped_ptr<z_stream_s> stream_;
+  int width_;
+  int height_;
+  int rows_written_;
+  bool finished_;
+
+  std::vector<unsigned char> prior_row_;
+  std::vector<unsigned char> current_row_;
+  std::vector<unsigned char> candidate_row_;
+  std::vector<unsigned char> filtered_row_;
+  std::vector<unsigned char> output_;
+
+  DISALLOW_COPY_AND_ASSIGN(PNGStreamEncoder);
+};
+
+}  // namespace nw
+
+#endif  // CONTENT_NW_SRC_BROWSER_PARALLEL_PNG_ENCODER_H_
@@ -150,6 +150,18 @@ void PrintJob::StartPrinting() {
       content::Details<JobEventDetails>(details.get()));
 }
 
+void PrintJob::OnPageAdded() {
+  DCHECK_EQ(ui_message_loop_, MessageLoop::current());
+  if (!is_job_pending_ || !worker_.get() || !worker_->message_loop())
+    return;
+
+  worker_->message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&HoldRefCallback, make_scoped_refptr(this),
+                 base::Bind(&PrintJobWorker::OnNewPage,
+                            base::Unretained(worker_.get()))));
+}
+
 void PrintJob::Stop() {
   DCHECK_EQ(ui_message_loop_, MessageLoop::current());
 
@@ -65,6 +65,10 @@ class PrintJob : public PrintJobWorkerOwner,
   // spool as soon as data is available.
   void StartPrinting();
 
+  // Tells the worker that a page was added to the document, so it spools the
+  // page right away instead of when its next poll comes.
+  void OnPageAdded();
+
   // Asks for the worker thread to finish its queued tasks and disconnects the
   // delegate object. The PrintJobManager will remove its reference. This may
   // have the side-effect of destroying the object if the caller doesn't have a
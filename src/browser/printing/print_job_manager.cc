@@ -4,16 +4,49 @@
 
 #include "content/nw/src/browser/printing/print_job_manager.h"
 
+#include "base/bind.h"
+#include "base/message_loop.h"
+#include "base/utf_string_conversions.h"
+#include "base/values.h"
 #include "content/nw/src/browser/printing/print_job.h"
 #include "content/nw/src/browser/printing/printer_query.h"
+#include "content/nw/src/nw_shell.h"
 #include "content/public/browser/notification_types.h"
 #include "content/public/browser/notification_service.h"
+#include "content/public/browser/render_view_host.h"
 #include "printing/printed_document.h"
 #include "printing/printed_page.h"
 
+namespace {
+
+// Jobs spooling at the same time, each to a different printer.
+const int kMaxConcurrentJobs = 4;
+
+const char kPrintJobEvent[] = "printjob";
+
+const char* const kPriorityNames[] = { "low", "normal", "high" };
+
+}  // namespace
+
 namespace printing {
 
-PrintJobManager::PrintJobManager() {
+PrintJobManager::ScheduledJob::ScheduledJob()
+    : cookie(0),
+      priority(PRIORITY_NORMAL),
+      sequence_number(0),
+      render_process_id(0),
+      render_view_id(0),
+      started(false),
+      canceled(false),
+      pages_printed(0) {
+}
+
+PrintJobManager::ScheduledJob::~ScheduledJob() {
+}
+
+PrintJobManager::PrintJobManager()
+    : next_sequence_number_(0),
+      weak_factory_(this) {
   registrar_.Add(this, content::NOTIFICATION_PRINT_JOB_EVENT,
                  content::NotificationService::AllSources());
 }
@@ -29,6 +62,15 @@ void PrintJobManager::OnQuit() {
 }
 
 void PrintJobManager::StopJobs(bool wait_for_finish) {
+  // The queued jobs never got to spool; drop them.
+  ScheduledJobs scheduled_jobs;
+  scheduled_jobs.swap(scheduled_jobs_);
+  for (ScheduledJobs::iterator it = scheduled_jobs.begin();
+       it != scheduled_jobs.end(); ++it) {
+    if (!it->started)
+      it->job->Stop();
+  }
+
   // Copy the array since it can be modified in transit.
   PrintJobs to_stop;
   to_stop.swap(current_jobs_);
@@ -71,6 +113,45 @@ void PrintJobManager::PopPrinterQuery(int document_cookie,
   }
 }
 
+void PrintJobManager::SchedulePrintJob(PrintJob* job,
+                                       Priority priority,
+                                       int render_process_id,
+                                       int render_view_id) {
+  DCHECK(job);
+  DCHECK(FindScheduledJob(job) == scheduled_jobs_.end());
+  ScheduledJob scheduled_job;
+  scheduled_job.job = job;
+  scheduled_job.cookie = job->cookie();
+  scheduled_job.priority = priority;
+  scheduled_job.sequence_number = next_sequence_number_++;
+  scheduled_job.render_process_id = render_process_id;
+  scheduled_job.render_view_id = render_view_id;
+  if (job->document())
+    scheduled_job.printer = UTF16ToUTF8(job->settings().device_name());
+  scheduled_jobs_.push_back(scheduled_job);
+
+  SendJobEvent(scheduled_jobs_.back(), "queued");
+  StartScheduledJobs();
+}
+
+bool PrintJobManager::CancelPrintJob(int cookie,
+                                     int render_process_id,
+                                     int render_view_id) {
+  for (ScheduledJobs::iterator it = scheduled_jobs_.begin();
+       it != scheduled_jobs_.end(); ++it) {
+    if (it->cookie != cookie ||
+        it->render_process_id != render_process_id ||
+        it->render_view_id != render_view_id)
+      continue;
+    it->canceled = true;
+    // Broadcasts FAILED, which takes the job off |scheduled_jobs_|.
+    scoped_refptr<PrintJob> job(it->job);
+    job->Cancel();
+    return true;
+  }
+  return false;
+}
+
 void PrintJobManager::Observe(int type,
                               const content::NotificationSource& source,
                               const content::NotificationDetails& details) {
@@ -95,22 +176,43 @@ void PrintJobManager::OnPrintJobEvent(
       DCHECK(current_jobs_.end() == current_jobs_.find(print_job));
       // Causes a AddRef().
       current_jobs_.insert(print_job);
+      ScheduledJobs::iterator it = FindScheduledJob(print_job);
+      if (it != scheduled_jobs_.end())
+        SendJobEvent(*it, "printing");
       break;
     }
-    case JobEventDetails::JOB_DONE: {
-      DCHECK(current_jobs_.end() != current_jobs_.find(print_job));
-      current_jobs_.erase(print_job);
+    case JobEventDetails::PAGE_DONE: {
+      ScheduledJobs::iterator it = FindScheduledJob(print_job);
+      if (it != scheduled_jobs_.end()) {
+        ++it->pages_printed;
+        SendJobEvent(*it, "printing");
+      }
       break;
     }
+    case JobEventDetails::JOB_DONE:
     case JobEventDetails::FAILED: {
+      DCHECK(event_details.type() == JobEventDetails::FAILED ||
+             current_jobs_.end() != current_jobs_.find(print_job));
       current_jobs_.erase(print_job);
+      ScheduledJobs::iterator it = FindScheduledJob(print_job);
+      if (it == scheduled_jobs_.end())
+        break;
+      std::string state = "done";
+      if (event_details.type() == JobEventDetails::FAILED)
+        state = it->canceled ? "canceled" : "failed";
+      SendJobEvent(*it, state);
+      scheduled_jobs_.erase(it);
+      // Let the job finish unwinding before the printer takes the next one.
+      MessageLoop::current()->PostTask(
+          FROM_HERE,
+          base::Bind(&PrintJobManager::StartScheduledJobs,
+                     weak_factory_.GetWeakPtr()));
       break;
     }
     case JobEventDetails::USER_INIT_DONE:
     case JobEventDetails::USER_INIT_CANCELED:
     case JobEventDetails::DEFAULT_INIT_DONE:
     case JobEventDetails::NEW_PAGE:
-    case JobEventDetails::PAGE_DONE:
     case JobEventDetails::DOC_DONE:
     case JobEventDetails::ALL_PAGES_REQUESTED: {
       // Don't care.
@@ -123,4 +225,80 @@ void PrintJobManager::OnPrintJobEvent(
   }
 }
 
+void PrintJobManager::StartScheduledJobs() {
+  int running = 0;
+  std::set<std::string> busy_printers;
+  for (ScheduledJobs::iterator it = scheduled_jobs_.begin();
+       it != scheduled_jobs_.end(); ++it) {
+    if (it->started) {
+      ++running;
+      busy_printers.insert(it->printer);
+    }
+  }
+
+  while (running < kMaxConcurrentJobs) {
+    ScheduledJobs::iterator next = scheduled_jobs_.end();
+    for (ScheduledJobs::iterator it = scheduled_jobs_.begin();
+         it != scheduled_jobs_.end(); ++it) {
+      if (it->started || busy_printers.count(it->printer))
+        continue;
+      if (next == scheduled_jobs_.end() || it->priority > next->priority ||
+          (it->priority == next->priority &&
+           it->sequence_number < next->sequence_number)) {
+        next = it;
+      }
+    }
+    if (next == scheduled_jobs_.end())
+      break;
+
+    scoped_refptr<PrintJob> job(next->job);
+    if (!job->document() || job->is_stopping() || job->is_stopped()) {
+      // Stopped by its view while it was waiting.
+      SendJobEvent(*next, "canceled");
+      scheduled_jobs_.erase(next);
+      continue;
+    }
+
+    next->started = true;
+    busy_printers.insert(next->printer);
+    ++running;
+    job->StartPrinting();
+  }
+}
+
+void PrintJobManager::SendJobEvent(const ScheduledJob& job,
+                                   const std::string& state) {
+  content::RenderViewHost* render_view_host =
+      content::RenderViewHost::FromID(job.render_process_id,
+                                      job.render_view_id);
+  if (!render_view_host)
+    return;
+  content::Shell* shell = content::Shell::FromRenderViewHost(render_view_host);
+  if (!shell)
+    return;
+
+  base::DictionaryValue* info = new base::DictionaryValue;
+  info->SetInteger("id", job.cookie);
+  info->SetString("state", state);
+  info->SetString("priority", kPriorityNames[job.priority]);
+  info->SetString("printer", job.printer);
+  info->SetInteger("pagesPrinted", job.pages_printed);
+  PrintedDocument* document = job.job->document();
+  if (document)
+    info->SetInteger("pageCount", document->page_count());
+  base::ListValue args;
+  args.Append(info);
+  shell->SendEvent(kPrintJobEvent, args);
+}
+
+PrintJobManager::ScheduledJobs::iterator PrintJobManager::FindScheduledJob(
+    PrintJob* print_job) {
+  for (ScheduledJobs::iterator it = scheduled_jobs_.begin();
+       it != scheduled_jobs_.end(); ++it) {
+    if (it->job.get() == print_job)
+      return it;
+  }
+  return scheduled_jobs_.end();
+}
+
 }  // namespace printing
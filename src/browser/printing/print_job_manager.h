@@ -5,10 +5,13 @@
 #ifndef CHROME_BROWSER_PRINTING_PRINT_JOB_MANAGER_H_
 #define CHROME_BROWSER_PRINTING_PRINT_JOB_MANAGER_H_
 
+#include <list>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
@@ -20,8 +23,19 @@ class JobEventDetails;
 class PrintJob;
 class PrinterQuery;
 
+// Keeps track of the print jobs and schedules them: jobs to different printers
+// spool at the same time, jobs to the same printer one after the other in
+// priority order. The window a job comes from gets "printjob" events as it
+// goes.
 class PrintJobManager : public content::NotificationObserver {
  public:
+  // Scheduling classes of print jobs. Higher ones start first.
+  enum Priority {
+    PRIORITY_LOW,
+    PRIORITY_NORMAL,
+    PRIORITY_HIGH,
+  };
+
   PrintJobManager();
   virtual ~PrintJobManager();
 
@@ -44,6 +58,20 @@ class PrintJobManager : public content::NotificationObserver {
   // called from any thread. Current use case is poping from the browser thread.
   void PopPrinterQuery(int document_cookie, scoped_refptr<PrinterQuery>* job);
 
+  // Queues |job| to start spooling as soon as its printer is free and fewer
+  // than kMaxConcurrentJobs jobs are spooling. |render_process_id| and
+  // |render_view_id| identify the window that gets the job's events.
+  void SchedulePrintJob(PrintJob* job,
+                        Priority priority,
+                        int render_process_id,
+                        int render_view_id);
+
+  // Cancels the job printing the document |cookie|, whether it is still
+  // queued or already spooling. Only the window that scheduled the job,
+  // identified by |render_process_id| and |render_view_id|, may cancel it.
+  // Returns false if that window has no such job.
+  bool CancelPrintJob(int cookie, int render_process_id, int render_view_id);
+
   // content::NotificationObserver
   virtual void Observe(int type,
                        const content::NotificationSource& source,
@@ -56,10 +84,36 @@ class PrintJobManager : public content::NotificationObserver {
   typedef std::set<scoped_refptr<PrintJob> > PrintJobs;
   typedef std::vector<scoped_refptr<PrinterQuery> > PrinterQueries;
 
+  struct ScheduledJob {
+    ScheduledJob();
+    ~ScheduledJob();
+
+    scoped_refptr<PrintJob> job;
+    int cookie;
+    Priority priority;
+    // Orders jobs of the same priority.
+    int sequence_number;
+    int render_process_id;
+    int render_view_id;
+    std::string printer;
+    bool started;
+    bool canceled;
+    int pages_printed;
+  };
+  typedef std::list<ScheduledJob> ScheduledJobs;
+
   // Processes a NOTIFY_PRINT_JOB_EVENT notification.
   void OnPrintJobEvent(PrintJob* print_job,
                        const JobEventDetails& event_details);
 
+  // Starts the queued jobs that can run now.
+  void StartScheduledJobs();
+
+  // Sends the "printjob" event for |job| in |state| to its window.
+  void SendJobEvent(const ScheduledJob& job, const std::string& state);
+
+  ScheduledJobs::iterator FindScheduledJob(PrintJob* print_job);
+
   content::NotificationRegistrar registrar_;
 
   // Used to serialize access to queued_workers_.
@@ -72,6 +126,13 @@ class PrintJobManager : public content::NotificationObserver {
   // Current print jobs that are active.
   PrintJobs current_jobs_;
 
+  // Jobs given to SchedulePrintJob(), until they are done or failed.
+  ScheduledJobs scheduled_jobs_;
+
+  int next_sequence_number_;
+
+  base::WeakPtrFactory<PrintJobManager> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(PrintJobManager);
 };
 
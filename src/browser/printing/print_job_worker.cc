@@ -27,6 +27,11 @@ using content::BrowserThread;
 
 namespace {
 
+// How long the worker waits for a page before looking again by itself.
+// Pages normally wake it up as they arrive; this only guards against a missed
+// PrintJob::OnPageAdded().
+const int kPageWaitTimeoutMs = 5000;
+
 // Helper function to ensure |owner| is valid until at least |callback| returns.
 void HoldRefCallback(const scoped_refptr<printing::PrintJobWorkerOwner>& owner,
                      const base::Closure& callback) {
@@ -52,6 +57,7 @@ void NotificationCallback(PrintJobWorkerOwner* print_job,
 PrintJobWorker::PrintJobWorker(PrintJobWorkerOwner* owner)
     : Thread("Printing_Worker"),
       owner_(owner),
+      page_wait_timeout_pending_(false),
       weak_factory_(this) {
   // The object is created in the IO thread.
   DCHECK_EQ(owner_->message_loop(), MessageLoop::current());
@@ -267,11 +273,16 @@ void PrintJobWorker::OnNewPage() {
     // Is the page available?
     scoped_refptr<PrintedPage> page;
     if (!document_->GetPage(page_number_.ToInt(), &page)) {
-      // We need to wait for the page to be available.
-      MessageLoop::current()->PostDelayedTask(
-          FROM_HERE,
-          base::Bind(&PrintJobWorker::OnNewPage, weak_factory_.GetWeakPtr()),
-          base::TimeDelta::FromMilliseconds(500));
+      // We need to wait for the page to be available. OnPageAdded() calls us
+      // back when it comes.
+      if (!page_wait_timeout_pending_) {
+        page_wait_timeout_pending_ = true;
+        MessageLoop::current()->PostDelayedTask(
+            FROM_HERE,
+            base::Bind(&PrintJobWorker::OnPageWaitTimeout,
+                       weak_factory_.GetWeakPtr()),
+            base::TimeDelta::FromMilliseconds(kPageWaitTimeoutMs));
+      }
       break;
     }
     // The page is there, print it.
@@ -285,6 +296,11 @@ void PrintJobWorker::OnNewPage() {
   }
 }
 
+void PrintJobWorker::OnPageWaitTimeout() {
+  page_wait_timeout_pending_ = false;
+  OnNewPage();
+}
+
 void PrintJobWorker::Cancel() {
   // This is the only function that can be called from any thread.
   printing_context_->Cancel();
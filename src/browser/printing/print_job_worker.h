@@ -62,9 +62,9 @@ class PrintJobWorker : public base::Thread {
   // Updates the printed document.
   void OnDocumentChanged(PrintedDocument* new_document);
 
-  // Dequeues waiting pages. Called when PrintJob receives a
-  // NOTIFY_PRINTED_DOCUMENT_UPDATED notification. It's time to look again if
-  // the next page can be printed.
+  // Dequeues waiting pages. Called by PrintJob::OnPageAdded() whenever the
+  // document gets a page. It's time to look again if the next page can be
+  // printed.
   void OnNewPage();
 
   // This is the only function that can be called in a thread.
@@ -85,6 +85,10 @@ class PrintJobWorker : public base::Thread {
   // Renders a page in the printer.
   void SpoolPage(PrintedPage* page);
 
+  // Looks for the next page again in case a PrintJob::OnPageAdded() call got
+  // lost.
+  void OnPageWaitTimeout();
+
   // Closes the job since spooling is done.
   void OnDocumentDone();
 
@@ -132,6 +136,9 @@ class PrintJobWorker : public base::Thread {
   // Current page number to print.
   PageNumber page_number_;
 
+  // Whether an OnPageWaitTimeout() task is posted.
+  bool page_wait_timeout_pending_;
+
   // Used to generate a WeakPtr for callbacks.
   base::WeakPtrFactory<PrintJobWorker> weak_factory_;
 
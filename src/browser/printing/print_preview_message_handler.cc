@@ -0,0 +1,328 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/nw/src/browser/printing/print_preview_message_handler.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/shared_memory.h"
+#include "base/values.h"
+#include "content/nw/src/browser/printing/print_job_manager.h"
+#include "content/nw/src/browser/printing/printer_query.h"
+#include "content/nw/src/common/print_messages.h"
+#include "content/nw/src/shell_content_browser_client.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/common/content_client.h"
+#include "printing/print_job_constants.h"
+
+using content::BrowserThread;
+using content::WebContents;
+
+DEFINE_WEB_CONTENTS_USER_DATA_KEY(printing::PrintPreviewMessageHandler);
+
+namespace printing {
+
+namespace {
+
+void WritePdfToFile(base::SharedMemory* data,
+                    uint32 data_size,
+                    const base::FilePath& path,
+                    bool* written) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  int size = static_cast<int>(data_size);
+  *written = file_util::WriteFile(
+      path, static_cast<const char*>(data->memory()), size) == size;
+}
+
+void CopyBooleanOption(const base::DictionaryValue& options,
+                       const char* option,
+                       const char* setting,
+                       base::DictionaryValue* settings) {
+  bool value = false;
+  options.GetBoolean(option, &value);
+  settings->SetBoolean(setting, value);
+}
+
+}  // namespace
+
+struct PrintPreviewMessageHandler::Job {
+  Job() : request_id(0), document_cookie(0) {}
+
+  base::DictionaryValue settings;
+  PrintToPDFCallback callback;
+  int request_id;
+  int document_cookie;
+  base::TimeTicks start_time;
+  Result result;
+};
+
+PrintPreviewMessageHandler::Result::Result()
+    : page_count(0),
+      data_size(0) {
+}
+
+PrintPreviewMessageHandler::Result::~Result() {
+}
+
+PrintPreviewMessageHandler::PrintPreviewMessageHandler(
+    WebContents* web_contents)
+    : content::WebContentsObserver(web_contents),
+      last_request_id_(0),
+      weak_ptr_factory_(this) {
+}
+
+PrintPreviewMessageHandler::~PrintPreviewMessageHandler() {
+  if (current_job_.get())
+    ReleasePrinterQuery(current_job_->document_cookie);
+  for (std::deque<Job*>::iterator it = queued_jobs_.begin();
+       it != queued_jobs_.end(); ++it)
+    delete *it;
+}
+
+void PrintPreviewMessageHandler::PrintToPDF(
+    const base::DictionaryValue& options,
+    const base::FilePath& path,
+    const PrintToPDFCallback& callback) {
+  scoped_ptr<Job> job(new Job);
+  job->callback = callback;
+  job->request_id = ++last_request_id_;
+  job->result.path = path;
+
+  base::DictionaryValue* settings = &job->settings;
+  settings->SetBoolean(kSettingPrintToPDF, true);
+  settings->SetBoolean(kSettingGenerateDraftData, false);
+  settings->SetBoolean(kSettingPreviewModifiable, true);
+  settings->SetBoolean(kSettingFitToPageEnabled, false);
+  settings->SetBoolean(kSettingCloudPrintDialog, false);
+  settings->SetBoolean(kSettingCollate, false);
+  settings->SetInteger(kSettingCopies, 1);
+  settings->SetInteger(kSettingColor, COLOR);
+  settings->SetInteger(kSettingDuplexMode, SIMPLEX);
+  settings->SetString(kSettingDeviceName, "");
+  settings->SetInteger(kPreviewUIID, routing_id());
+  settings->SetInteger(kPreviewRequestID, job->request_id);
+  settings->SetBoolean(kIsFirstRequest, true);
+
+  CopyBooleanOption(options, "landscape", kSettingLandscape, settings);
+  CopyBooleanOption(options, "printBackground",
+                    kSettingShouldPrintBackgrounds, settings);
+  CopyBooleanOption(options, "selectionOnly",
+                    kSettingShouldPrintSelectionOnly, settings);
+  CopyBooleanOption(options, "headerFooter",
+                    kSettingHeaderFooterEnabled, settings);
+
+  string16 title = web_contents()->GetTitle();
+  options.GetString("title", &title);
+  settings->SetString(kSettingHeaderFooterTitle, title);
+  std::string url = web_contents()->GetURL().spec();
+  options.GetString("url", &url);
+  settings->SetString(kSettingHeaderFooterURL, url);
+
+  int margins_type = DEFAULT_MARGINS;
+  options.GetInteger("marginsType", &margins_type);
+  if (margins_type < DEFAULT_MARGINS || margins_type > CUSTOM_MARGINS)
+    margins_type = DEFAULT_MARGINS;
+  settings->SetInteger(kSettingMarginsType, margins_type);
+  const base::DictionaryValue* margins;
+  if (margins_type == CUSTOM_MARGINS &&
+      options.GetDictionary("margins", &margins)) {
+    double top = 0, bottom = 0, left = 0, right = 0;
+    margins->GetDouble("top", &top);
+    margins->GetDouble("bottom", &bottom);
+    margins->GetDouble("left", &left);
+    margins->GetDouble("right", &right);
+    base::DictionaryValue* custom_margins = new base::DictionaryValue;
+    custom_margins->SetDouble(kSettingMarginTop, top);
+    custom_margins->SetDouble(kSettingMarginBottom, bottom);
+    custom_margins->SetDouble(kSettingMarginLeft, left);
+    custom_margins->SetDouble(kSettingMarginRight, right);
+    settings->Set(kSettingMarginsCustom, custom_margins);
+  }
+
+  const base::DictionaryValue* page_size;
+  if (options.GetDictionary("pageSize", &page_size))
+    settings->Set(kSettingPageSizeMicrons, page_size->DeepCopy());
+
+  const base::ListValue* page_ranges;
+  if (options.GetList("pageRanges", &page_ranges)) {
+    base::ListValue* ranges = new base::ListValue;
+    for (size_t i = 0; i < page_ranges->GetSize(); ++i) {
+      const base::DictionaryValue* range;
+      int from = 0, to = 0;
+      if (!page_ranges->GetDictionary(i, &range) ||
+          !range->GetInteger("from", &from) ||
+          !range->GetInteger("to", &to) ||
+          from < 1 || to < from)
+        continue;
+      base::DictionaryValue* page_range = new base::DictionaryValue;
+      page_range->SetInteger(kSettingPageRangeFrom, from);
+      page_range->SetInteger(kSettingPageRangeTo, to);
+      ranges->Append(page_range);
+    }
+    settings->Set(kSettingPageRange, ranges);
+  }
+
+  queued_jobs_.push_back(job.release());
+  StartNextJob();
+}
+
+bool PrintPreviewMessageHandler::OnMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(PrintPreviewMessageHandler, message)
+    IPC_MESSAGE_HANDLER(PrintHostMsg_DidGetPreviewPageCount,
+                        OnDidGetPreviewPageCount)
+    IPC_MESSAGE_HANDLER(PrintHostMsg_MetafileReadyForPrinting,
+                        OnMetafileReadyForPrinting)
+    IPC_MESSAGE_HANDLER(PrintHostMsg_PrintPreviewFailed,
+                        OnPrintPreviewFailed)
+    IPC_MESSAGE_HANDLER(PrintHostMsg_PrintPreviewCancelled,
+                        OnPrintPreviewFailed)
+    IPC_MESSAGE_HANDLER(PrintHostMsg_PrintPreviewInvalidPrinterSettings,
+                        OnPrintPreviewFailed)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void PrintPreviewMessageHandler::RenderViewGone(
+    base::TerminationStatus status) {
+  // Fail the queued jobs as well rather than sending them to whatever
+  // renderer comes next.
+  std::deque<Job*> queued_jobs;
+  queued_jobs.swap(queued_jobs_);
+  const char kError[] = "Renderer process is gone";
+  if (current_job_.get())
+    FinishCurrentJob(kError);
+  for (std::deque<Job*>::iterator it = queued_jobs.begin();
+       it != queued_jobs.end(); ++it) {
+    scoped_ptr<Job> job(*it);
+    job->result.error = kError;
+    job->callback.Run(&job->result);
+  }
+}
+
+void PrintPreviewMessageHandler::OnDidGetPreviewPageCount(
+    const PrintHostMsg_DidGetPreviewPageCount_Params& params) {
+  if (!current_job_.get() ||
+      params.preview_request_id != current_job_->request_id)
+    return;
+  current_job_->document_cookie = params.document_cookie;
+  current_job_->result.page_count = params.page_count;
+}
+
+void PrintPreviewMessageHandler::OnMetafileReadyForPrinting(
+    const PrintHostMsg_DidPreviewDocument_Params& params) {
+  if (!current_job_.get() ||
+      params.preview_request_id != current_job_->request_id)
+    return;
+  current_job_->document_cookie = params.document_cookie;
+  current_job_->result.page_count = params.expected_pages_count;
+
+  // The handle is already valid in the browser process.
+  scoped_ptr<base::SharedMemory> shared_buf(
+      new base::SharedMemory(params.metafile_data_handle, true));
+  if (!params.data_size || !shared_buf->Map(params.data_size)) {
+    FinishCurrentJob("Failed to map the PDF data");
+    return;
+  }
+
+  Job* job = current_job_.get();
+  Result* result = &job->result;
+  result->elapsed = base::TimeTicks::Now() - job->start_time;
+  result->layout_time = params.layout_time;
+  result->render_time = params.render_time;
+  result->finalize_time = params.finalize_time;
+  // Whatever the renderer did not account for went to messaging and
+  // waiting in queues.
+  result->ipc_time = std::max(base::TimeDelta(),
+                              result->elapsed - params.layout_time -
+                                  params.render_time - params.finalize_time);
+  result->data_size = params.data_size;
+  ReleasePrinterQuery(job->document_cookie);
+  job->document_cookie = 0;
+
+  if (job->result.path.empty()) {
+    job->result.data.swap(shared_buf);
+    FinishCurrentJob(std::string());
+    return;
+  }
+
+  // Write the file off the UI thread; the renderer is free for the next job
+  // meanwhile.
+  bool* written = new bool(false);
+  BrowserThread::PostTaskAndReply(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&WritePdfToFile, base::Owned(shared_buf.release()),
+                 params.data_size, job->result.path, written),
+      base::Bind(&PrintPreviewMessageHandler::OnPdfWritten,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 base::Owned(current_job_.release()), base::Owned(written)));
+  StartNextJob();
+}
+
+void PrintPreviewMessageHandler::OnPrintPreviewFailed(int document_cookie) {
+  if (!current_job_.get())
+    return;
+  if (document_cookie)
+    current_job_->document_cookie = document_cookie;
+  FinishCurrentJob("Failed to render the PDF");
+}
+
+void PrintPreviewMessageHandler::StartNextJob() {
+  if (current_job_.get() || queued_jobs_.empty())
+    return;
+  current_job_.reset(queued_jobs_.front());
+  queued_jobs_.pop_front();
+  current_job_->start_time = base::TimeTicks::Now();
+  Send(new PrintMsg_PrintToPDF(routing_id(), current_job_->settings));
+}
+
+void PrintPreviewMessageHandler::FinishCurrentJob(const std::string& error) {
+  scoped_ptr<Job> job(current_job_.Pass());
+  ReleasePrinterQuery(job->document_cookie);
+  job->result.error = error;
+  if (!error.empty()) {
+    job->result.data.reset();
+    job->result.data_size = 0;
+  }
+  job->result.elapsed = base::TimeTicks::Now() - job->start_time;
+  // The callback may queue another job.
+  StartNextJob();
+  job->callback.Run(&job->result);
+}
+
+void PrintPreviewMessageHandler::OnPdfWritten(Job* job, bool* written) {
+  job->result.write_time =
+      base::TimeTicks::Now() - job->start_time - job->result.elapsed;
+  if (!*written)
+    job->result.error = "Failed to write " + job->result.path.AsUTF8Unsafe();
+  job->callback.Run(&job->result);
+}
+
+void PrintPreviewMessageHandler::ReleasePrinterQuery(int document_cookie) {
+  if (!document_cookie)
+    return;
+
+  content::ShellContentBrowserClient* browser_client =
+    static_cast<content::ShellContentBrowserClient*>(content::GetContentClient()->browser());
+  printing::PrintJobManager* print_job_manager =
+      browser_client->print_job_manager();
+  if (!print_job_manager)
+    return;
+
+  scoped_refptr<printing::PrinterQuery> printer_query;
+  print_job_manager->PopPrinterQuery(document_cookie, &printer_query);
+  if (!printer_query.get())
+    return;
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&PrinterQuery::StopWorker, printer_query.get()));
+}
+
+}  // namespace printing
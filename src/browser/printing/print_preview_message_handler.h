@@ -0,0 +1,124 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NW_BROWSER_PRINTING_PRINT_PREVIEW_MESSAGE_HANDLER_H_
+#define NW_BROWSER_PRINTING_PRINT_PREVIEW_MESSAGE_HANDLER_H_
+
+#include <deque>
+#include <string>
+
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+
+struct PrintHostMsg_DidGetPreviewPageCount_Params;
+struct PrintHostMsg_DidPreviewDocument_Params;
+
+namespace base {
+class DictionaryValue;
+class SharedMemory;
+}
+
+namespace printing {
+
+// Renders the page of a WebContents into a PDF document through the print
+// preview pipeline of PrintWebViewHelper, without a dialog or a printer.
+// Jobs run one after the other; the renderer lays out the document once per
+// job and sends the finished PDF back in shared memory.
+class PrintPreviewMessageHandler
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<PrintPreviewMessageHandler> {
+ public:
+  struct Result {
+    Result();
+    ~Result();
+
+    // Empty on success.
+    std::string error;
+
+    int page_count;
+    base::TimeDelta elapsed;
+
+    // Where the time went: laying out and counting the pages, rendering
+    // them and finishing the PDF in the renderer, getting the PDF to the
+    // browser, and writing it to |path|. |elapsed| does not include
+    // |write_time|.
+    base::TimeDelta layout_time;
+    base::TimeDelta render_time;
+    base::TimeDelta finalize_time;
+    base::TimeDelta ipc_time;
+    base::TimeDelta write_time;
+
+    // The PDF was written to |path| if one was given, otherwise it is in
+    // |data|.
+    base::FilePath path;
+    scoped_ptr<base::SharedMemory> data;
+    uint32 data_size;
+  };
+
+  typedef base::Callback<void(Result* result)> PrintToPDFCallback;
+
+  virtual ~PrintPreviewMessageHandler();
+
+  // Prints to a PDF with |options|:
+  //   "landscape": bool,
+  //   "pageSize": { "width", "height" } in microns,
+  //   "marginsType": printing::MarginType,
+  //   "margins": { "top", "bottom", "left", "right" } in points, for
+  //              CUSTOM_MARGINS,
+  //   "headerFooter": bool, with "title" and "url" to show in them,
+  //   "printBackground": bool,
+  //   "pageRanges": [ { "from", "to" } ], 1-based and inclusive.
+  // The PDF is written to |path| unless it is empty. |callback| is not run
+  // if the WebContents goes away first.
+  void PrintToPDF(const base::DictionaryValue& options,
+                  const base::FilePath& path,
+                  const PrintToPDFCallback& callback);
+
+  // content::WebContentsObserver implementation.
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
+  virtual void RenderViewGone(base::TerminationStatus status) OVERRIDE;
+
+ private:
+  explicit PrintPreviewMessageHandler(content::WebContents* web_contents);
+  friend class content::WebContentsUserData<PrintPreviewMessageHandler>;
+
+  struct Job;
+
+  // IPC Message handlers.
+  void OnDidGetPreviewPageCount(
+      const PrintHostMsg_DidGetPreviewPageCount_Params& params);
+  void OnMetafileReadyForPrinting(
+      const PrintHostMsg_DidPreviewDocument_Params& params);
+  void OnPrintPreviewFailed(int document_cookie);
+
+  // Sends the next queued job to the renderer, if none is rendering.
+  void StartNextJob();
+
+  // Ends the rendering job with |error|, or with success if it is empty.
+  void FinishCurrentJob(const std::string& error);
+
+  void OnPdfWritten(Job* job, bool* written);
+
+  // Stops the PrinterQuery the renderer got its settings from.
+  void ReleasePrinterQuery(int document_cookie);
+
+  std::deque<Job*> queued_jobs_;
+  scoped_ptr<Job> current_job_;
+
+  int last_request_id_;
+
+  base::WeakPtrFactory<PrintPreviewMessageHandler> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrintPreviewMessageHandler);
+};
+
+}  // namespace printing
+
+#endif  // NW_BROWSER_PRINTING_PRINT_PREVIEW_MESSAGE_HANDLER_H_
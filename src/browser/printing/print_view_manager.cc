@@ -10,6 +10,7 @@
 #include "base/command_line.h"
 #include "base/lazy_instance.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/timer.h"
@@ -33,6 +34,7 @@
 #include "content/public/browser/notification_details.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/notification_source.h"
+#include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/web_contents_view.h"
@@ -54,6 +56,17 @@ namespace {
 // Limits memory usage by raster to 64 MiB.
 const int kMaxRasterSizeInPixels = 16*1024*1024;
 
+// How long a detached job waits for its missing pages. The renderer could be
+// CPU bound, the page overly complex/large or the system just memory-bound;
+// give it a minute.
+const int kPendingJobTimeoutMs = 60000;
+
+void CancelIfIncomplete(scoped_refptr<printing::PrintJob> print_job) {
+  printing::PrintedDocument* document = print_job->document();
+  if (document && !document->IsComplete())
+    print_job->Cancel();
+}
+
 }  // namespace
 
 namespace printing {
@@ -62,11 +75,12 @@ PrintViewManager::PrintViewManager(content::WebContents* web_contents)
     : content::WebContentsObserver(web_contents),
       number_pages_(0),
       printing_succeeded_(false),
-      inside_inner_message_loop_(false),
+      print_priority_(PrintJobManager::PRIORITY_NORMAL),
       observer_(NULL),
       cookie_(0),
       scripted_print_preview_rph_(NULL),
-      tab_content_blocked_(false) {
+      tab_content_blocked_(false),
+      weak_ptr_factory_(this) {
 #if defined(OS_POSIX) && !defined(OS_MACOSX)
   expecting_first_page_ = true;
 #endif
@@ -78,6 +92,16 @@ PrintViewManager::PrintViewManager(content::WebContents* web_contents)
 PrintViewManager::~PrintViewManager() {
   ReleasePrinterQuery();
   DisconnectFromCurrentPrintJob();
+  // Jobs still missing pages outlive the view and get the rest of their
+  // time; they are only canceled by the timeout.
+  for (PendingJobs::iterator it = pending_jobs_.begin();
+       it != pending_jobs_.end(); ++it) {
+    it->second->DisconnectSource();
+    MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&CancelIfIncomplete, it->second),
+        TimeDelta::FromMilliseconds(kPendingJobTimeoutMs));
+  }
 }
 
 bool PrintViewManager::PrintNow() {
@@ -160,10 +184,19 @@ void PrintViewManager::OnDidShowPrintDialog() {
 
 void PrintViewManager::OnDidPrintPage(
     const PrintHostMsg_DidPrintPage_Params& params) {
-  if (!OpportunisticallyCreatePrintJob(params.document_cookie))
-    return;
+  // The rest of the pages of a detached job.
+  PendingJobs::iterator pending = pending_jobs_.find(params.document_cookie);
+  bool is_pending_job = pending != pending_jobs_.end();
+  scoped_refptr<PrintJob> print_job;
+  if (is_pending_job) {
+    print_job = pending->second;
+  } else {
+    if (!OpportunisticallyCreatePrintJob(params.document_cookie))
+      return;
+    print_job = print_job_;
+  }
 
-  PrintedDocument* document = print_job_->document();
+  PrintedDocument* document = print_job->document();
   if (!document || params.document_cookie != document->cookie()) {
     // Out of sync. It may happen since we are completely asynchronous. Old
     // spurious messages can be received if one of the processes is overloaded.
@@ -173,8 +206,15 @@ void PrintViewManager::OnDidPrintPage(
 #if defined(OS_WIN) || defined(OS_MACOSX)
   const bool metafile_must_be_valid = true;
 #elif defined(OS_POSIX)
-  const bool metafile_must_be_valid = expecting_first_page_;
-  expecting_first_page_ = false;
+  // Only the first page carries the document.
+  bool metafile_must_be_valid;
+  if (is_pending_job) {
+    metafile_must_be_valid =
+        base::SharedMemory::IsHandleValid(params.metafile_data_handle);
+  } else {
+    metafile_must_be_valid = expecting_first_page_;
+    expecting_first_page_ = false;
+  }
 #endif
 
   base::SharedMemory shared_buf(params.metafile_data_handle, true);
@@ -208,7 +248,10 @@ void PrintViewManager::OnDidPrintPage(
     } else if (big_emf) {
       // Don't fall back to emf here.
       NOTREACHED() << "size:" << params.data_size;
-      TerminatePrintJob(true);
+      if (is_pending_job)
+        ReleasePendingJob(params.document_cookie, true);
+      else
+        TerminatePrintJob(true);
       web_contents()->Stop();
       return;
     }
@@ -221,8 +264,10 @@ void PrintViewManager::OnDidPrintPage(
                     params.actual_shrink,
                     params.page_size,
                     params.content_area);
+  print_job->OnPageAdded();
 
-  ShouldQuitFromInnerMessageLoop();
+  if (is_pending_job && document->IsComplete())
+    ReleasePendingJob(params.document_cookie, false);
 }
 
 void PrintViewManager::OnPrintingFailed(int cookie) {
@@ -308,10 +353,7 @@ void PrintViewManager::OnNotifyPrintJobEvent(
       NOTREACHED();
       break;
     }
-    case JobEventDetails::ALL_PAGES_REQUESTED: {
-      ShouldQuitFromInnerMessageLoop();
-      break;
-    }
+    case JobEventDetails::ALL_PAGES_REQUESTED:
     case JobEventDetails::NEW_DOC:
     case JobEventDetails::NEW_PAGE:
     case JobEventDetails::PAGE_DONE:
@@ -339,58 +381,7 @@ void PrintViewManager::OnNotifyPrintJobEvent(
   }
 }
 
-bool PrintViewManager::RenderAllMissingPagesNow() {
-  if (!print_job_.get() || !print_job_->is_job_pending())
-    return false;
-
-  // We can't print if there is no renderer.
-  if (!web_contents() ||
-      !web_contents()->GetRenderViewHost() ||
-      !web_contents()->GetRenderViewHost()->IsRenderViewLive()) {
-    return false;
-  }
-
-  // Is the document already complete?
-  if (print_job_->document() && print_job_->document()->IsComplete()) {
-    printing_succeeded_ = true;
-    return true;
-  }
-
-  // WebContents is either dying or a second consecutive request to print
-  // happened before the first had time to finish. We need to render all the
-  // pages in an hurry if a print_job_ is still pending. No need to wait for it
-  // to actually spool the pages, only to have the renderer generate them. Run
-  // a message loop until we get our signal that the print job is satisfied.
-  // PrintJob will send a ALL_PAGES_REQUESTED after having received all the
-  // pages it needs. MessageLoop::current()->Quit() will be called as soon as
-  // print_job_->document()->IsComplete() is true on either ALL_PAGES_REQUESTED
-  // or in DidPrintPage(). The check is done in
-  // ShouldQuitFromInnerMessageLoop().
-  // BLOCKS until all the pages are received. (Need to enable recursive task)
-  if (!RunInnerMessageLoop()) {
-    // This function is always called from DisconnectFromCurrentPrintJob() so we
-    // know that the job will be stopped/canceled in any case.
-    return false;
-  }
-  return true;
-}
-
-void PrintViewManager::ShouldQuitFromInnerMessageLoop() {
-  // Look at the reason.
-  DCHECK(print_job_->document());
-  if (print_job_->document() &&
-      print_job_->document()->IsComplete() &&
-      inside_inner_message_loop_) {
-    // We are in a message loop created by RenderAllMissingPagesNow. Quit from
-    // it.
-    MessageLoop::current()->Quit();
-    inside_inner_message_loop_ = false;
-  }
-}
-
 bool PrintViewManager::CreateNewPrintJob(PrintJobWorkerOwner* job) {
-  DCHECK(!inside_inner_message_loop_);
-
   // Disconnect the current print_job_.
   DisconnectFromCurrentPrintJob();
 
@@ -416,18 +407,14 @@ bool PrintViewManager::CreateNewPrintJob(PrintJobWorkerOwner* job) {
 }
 
 void PrintViewManager::DisconnectFromCurrentPrintJob() {
-  // Make sure all the necessary rendered page are done. Don't bother with the
-  // return value.
-  bool result = RenderAllMissingPagesNow();
-
-  // Verify that assertion.
   if (print_job_.get() &&
       print_job_->document() &&
       !print_job_->document()->IsComplete()) {
-    DCHECK(!result);
-    // That failed.
-    TerminatePrintJob(true);
+    // Let the missing pages come in without blocking.
+    DetachIncompletePrintJob();
   } else {
+    if (print_job_.get() && print_job_->document())
+      printing_succeeded_ = true;
     // DO NOT wait for the job to finish.
     ReleasePrintJob();
   }
@@ -439,7 +426,7 @@ void PrintViewManager::DisconnectFromCurrentPrintJob() {
 void PrintViewManager::PrintingDone(bool success) {
   if (!print_job_.get())
     return;
-  Send(new PrintMsg_PrintingDone(routing_id(), success));
+  Send(new PrintMsg_PrintingDone(routing_id(), print_job_->cookie(), success));
 }
 
 void PrintViewManager::TerminatePrintJob(bool cancel) {
@@ -449,16 +436,12 @@ void PrintViewManager::TerminatePrintJob(bool cancel) {
   if (cancel) {
     // We don't need the metafile data anymore because the printing is canceled.
     print_job_->Cancel();
-    inside_inner_message_loop_ = false;
-  } else {
-    DCHECK(!inside_inner_message_loop_);
+  } else if (print_job_->is_job_pending()) {
     DCHECK(!print_job_->document() || print_job_->document()->IsComplete());
-
-    // WebContents is either dying or navigating elsewhere. We need to render
-    // all the pages in an hurry if a print job is still pending. This does the
-    // trick since it runs a blocking message loop:
     print_job_->Stop();
   }
+  // A complete job still queued in the PrintJobManager prints when its turn
+  // comes.
   ReleasePrintJob();
 }
 
@@ -475,40 +458,35 @@ void PrintViewManager::ReleasePrintJob() {
   print_job_ = NULL;
 }
 
-bool PrintViewManager::RunInnerMessageLoop() {
-  // This value may actually be too low:
-  //
-  // - If we're looping because of printer settings initialization, the premise
-  // here is that some poor users have their print server away on a VPN over a
-  // slow connection. In this situation, the simple fact of opening the printer
-  // can be dead slow. On the other side, we don't want to die infinitely for a
-  // real network error. Give the printer 60 seconds to comply.
-  //
-  // - If we're looping because of renderer page generation, the renderer could
-  // be CPU bound, the page overly complex/large or the system just
-  // memory-bound.
-  static const int kPrinterSettingsTimeout = 60000;
-  base::OneShotTimer<MessageLoop> quit_timer;
-  quit_timer.Start(FROM_HERE,
-                   TimeDelta::FromMilliseconds(kPrinterSettingsTimeout),
-                   MessageLoop::current(), &MessageLoop::Quit);
-
-  inside_inner_message_loop_ = true;
-
-  // Need to enable recursive task.
-  {
-    MessageLoop::ScopedNestableTaskAllower allow(MessageLoop::current());
-    MessageLoop::current()->Run();
-  }
+void PrintViewManager::DetachIncompletePrintJob() {
+  int cookie = print_job_->cookie();
+  registrar_.Remove(this, content::NOTIFICATION_PRINT_JOB_EVENT,
+                    content::Source<PrintJob>(print_job_.get()));
+  pending_jobs_[cookie] = print_job_;
+  print_job_ = NULL;
 
-  bool success = true;
-  if (inside_inner_message_loop_) {
-    // Ok we timed out. That's sad.
-    inside_inner_message_loop_ = false;
-    success = false;
-  }
+  MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&PrintViewManager::OnPendingJobTimeout,
+                 weak_ptr_factory_.GetWeakPtr(), cookie),
+      TimeDelta::FromMilliseconds(kPendingJobTimeoutMs));
+}
+
+void PrintViewManager::ReleasePendingJob(int cookie, bool cancel) {
+  PendingJobs::iterator it = pending_jobs_.find(cookie);
+  if (it == pending_jobs_.end())
+    return;
+  scoped_refptr<PrintJob> print_job(it->second);
+  pending_jobs_.erase(it);
+
+  if (cancel)
+    print_job->Cancel();
+  Send(new PrintMsg_PrintingDone(routing_id(), cookie, !cancel));
+  print_job->DisconnectSource();
+}
 
-  return success;
+void PrintViewManager::OnPendingJobTimeout(int cookie) {
+  ReleasePendingJob(cookie, true);
 }
 
 bool PrintViewManager::OpportunisticallyCreatePrintJob(int cookie) {
@@ -536,9 +514,11 @@ bool PrintViewManager::OpportunisticallyCreatePrintJob(int cookie) {
     return false;
   }
 
-  // Settings are already loaded. Go ahead. This will set
-  // print_job_->is_job_pending() to true.
-  print_job_->StartPrinting();
+  // Settings are already loaded. The manager starts spooling when the printer
+  // is free, which sets print_job_->is_job_pending() to true.
+  browser_client->print_job_manager()->SchedulePrintJob(
+      print_job_.get(), print_priority_,
+      web_contents()->GetRenderProcessHost()->GetID(), routing_id());
   return true;
 }
 
@@ -5,13 +5,17 @@
 #ifndef CHROME_BROWSER_PRINTING_PRINT_VIEW_MANAGER_H_
 #define CHROME_BROWSER_PRINTING_PRINT_VIEW_MANAGER_H_
 
+#include <map>
+
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "base/prefs/pref_member.h"
 #include "base/string16.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
+#include "content/nw/src/browser/printing/print_job_manager.h"
 #include "printing/printed_pages_source.h"
 
 struct PrintHostMsg_DidPrintPage_Params;
@@ -53,6 +57,11 @@ class PrintViewManager : public content::NotificationObserver,
   // Whether to block scripted printing for our tab or not.
   void UpdateScriptedPrintingBlocked();
 
+  // Sets the priority the print jobs of this tab are scheduled with.
+  void set_print_priority(PrintJobManager::Priority priority) {
+    print_priority_ = priority;
+  }
+
   // Sets |observer| as the current PrintViewManagerObserver. Pass in NULL to
   // remove the current observer. |observer| may always be NULL, but |observer_|
   // must be NULL if |observer| is non-NULL.
@@ -103,17 +112,17 @@ class PrintViewManager : public content::NotificationObserver,
   // Processes a NOTIFY_PRINT_JOB_EVENT notification.
   void OnNotifyPrintJobEvent(const JobEventDetails& event_details);
 
-  // Requests the RenderView to render all the missing pages for the print job.
-  // No-op if no print job is pending. Returns true if at least one page has
-  // been requested to the renderer.
-  bool RenderAllMissingPagesNow();
+  // Stops feeding print_job_ while its document still misses pages. The job
+  // is kept in |pending_jobs_| and completes as the rest of its pages come
+  // in, or is canceled after a timeout.
+  void DetachIncompletePrintJob();
+
+  // Releases the pending job of document |cookie| once it is complete, or
+  // cancels it if |cancel| is true.
+  void ReleasePendingJob(int cookie, bool cancel);
 
-  // Quits the current message loop if these conditions hold true: a document is
-  // loaded and is complete and waiting_for_pages_to_be_rendered_ is true. This
-  // function is called in DidPrintPage() or on ALL_PAGES_REQUESTED
-  // notification. The inner message loop is created was created by
-  // RenderAllMissingPagesNow().
-  void ShouldQuitFromInnerMessageLoop();
+  // Cancels the pending job of document |cookie| if it is still incomplete.
+  void OnPendingJobTimeout(int cookie);
 
   // Creates a new empty print job. It has no settings loaded. If there is
   // currently a print job, safely disconnect from it. Returns false if it is
@@ -121,8 +130,8 @@ class PrintViewManager : public content::NotificationObserver,
   // impossible to create a new print job.
   bool CreateNewPrintJob(PrintJobWorkerOwner* job);
 
-  // Makes sure the current print_job_ has all its data before continuing, and
-  // disconnect from it.
+  // Disconnects from the current print_job_ without waiting for it; a job
+  // still missing pages goes to DetachIncompletePrintJob().
   void DisconnectFromCurrentPrintJob();
 
   // Notify that the printing is done.
@@ -137,12 +146,6 @@ class PrintViewManager : public content::NotificationObserver,
   // no print job has been created.
   void ReleasePrintJob();
 
-  // Runs an inner message loop. It will set inside_inner_message_loop_ to true
-  // while the blocking inner message loop is running. This is useful in cases
-  // where the RenderView is about to be destroyed while a printing job isn't
-  // finished.
-  bool RunInnerMessageLoop();
-
   // In the case of Scripted Printing, where the renderer is controlling the
   // control flow, print_job_ is initialized whenever possible. No-op is
   // print_job_ is initialized.
@@ -165,10 +168,13 @@ class PrintViewManager : public content::NotificationObserver,
   // Indication of success of the print job.
   bool printing_succeeded_;
 
-  // Running an inner message loop inside RenderAllMissingPagesNow(). This means
-  // we are _blocking_ until all the necessary pages have been rendered or the
-  // print settings are being loaded.
-  bool inside_inner_message_loop_;
+  // Jobs detached while their document was incomplete, by document cookie.
+  // OnDidPrintPage() still feeds them.
+  typedef std::map<int, scoped_refptr<PrintJob> > PendingJobs;
+  PendingJobs pending_jobs_;
+
+  // Priority of the print jobs of this tab.
+  PrintJobManager::Priority print_priority_;
 
 #if defined(OS_POSIX) && !defined(OS_MACOSX)
   // Set to true when OnDidPrintPage() should be expecting the first page.
@@ -192,6 +198,8 @@ class PrintViewManager : public content::NotificationObserver,
   // Whether our content is in blocked state.
   bool tab_content_blocked_;
 
+  base::WeakPtrFactory<PrintViewManager> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(PrintViewManager);
 };
 
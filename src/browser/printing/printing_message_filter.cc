@@ -17,6 +17,8 @@
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/web_contents_view.h"
 #include "content/public/common/content_client.h"
+#include "printing/units.h"
+#include "ui/gfx/size.h"
 
 #if defined(OS_CHROMEOS)
 #include <fcntl.h>
@@ -45,6 +47,19 @@ static base::LazyInstance<PrintingSequencePathMap>
     g_printing_file_descriptor_map = LAZY_INSTANCE_INITIALIZER;
 #endif
 
+// Replaces the paper of |settings| with one of |microns|, printable up to
+// its edges. Used by PDF jobs, which print on a virtual paper.
+void OverridePaperSize(const gfx::Size& microns,
+                       printing::PrintSettings* settings) {
+  int units_per_inch = settings->device_units_per_inch();
+  gfx::Size paper_size(
+      printing::ConvertUnit(microns.width(), printing::kMicronsPerInch,
+                            units_per_inch),
+      printing::ConvertUnit(microns.height(), printing::kMicronsPerInch,
+                            units_per_inch));
+  settings->SetPrinterPrintableArea(paper_size, gfx::Rect(paper_size), true);
+}
+
 void RenderParamsFromPrintSettings(const printing::PrintSettings& settings,
                                    PrintMsg_Print_Params* params) {
   params->page_size = settings.page_setup_device_units().physical_size();
@@ -338,21 +353,36 @@ void PrintingMessageFilter::OnUpdatePrintSettings(
     printer_query = new printing::PrinterQuery;
     printer_query->SetWorkerDestination(print_job_manager_->destination());
   }
+  gfx::Size page_size_microns;
+  const DictionaryValue* page_size;
+  if (job_settings.GetDictionary(printing::kSettingPageSizeMicrons,
+                                 &page_size)) {
+    int width = 0, height = 0;
+    if (page_size->GetInteger("width", &width) &&
+        page_size->GetInteger("height", &height) &&
+        width > 0 && height > 0) {
+      page_size_microns.SetSize(width, height);
+    }
+  }
   printer_query->SetSettings(
       job_settings,
       base::Bind(&PrintingMessageFilter::OnUpdatePrintSettingsReply, this,
-                 printer_query, reply_msg));
+                 printer_query, page_size_microns, reply_msg));
 }
 
 void PrintingMessageFilter::OnUpdatePrintSettingsReply(
     scoped_refptr<printing::PrinterQuery> printer_query,
+    const gfx::Size& page_size_microns,
     IPC::Message* reply_msg) {
   PrintMsg_PrintPages_Params params;
   if (!printer_query.get() ||
       printer_query->last_status() != printing::PrintingContext::OK) {
     params.Reset();
   } else {
-    RenderParamsFromPrintSettings(printer_query->settings(), &params.params);
+    printing::PrintSettings settings(printer_query->settings());
+    if (!page_size_microns.IsEmpty())
+      OverridePaperSize(page_size_microns, &settings);
+    RenderParamsFromPrintSettings(settings, &params.params);
     params.params.document_cookie = printer_query->cookie();
     params.pages =
         printing::PageRange::GetPages(printer_query->settings().ranges);
@@ -371,4 +401,6 @@ void PrintingMessageFilter::OnUpdatePrintSettingsReply(
 void PrintingMessageFilter::OnCheckForCancel(int32 preview_ui_id,
                                              int preview_request_id,
                                              bool* cancel) {
+  // There is no print preview UI to cancel from.
+  *cancel = false;
 }
@@ -25,6 +25,10 @@ namespace content {
 class WebContents;
 }
 
+namespace gfx {
+class Size;
+}
+
 namespace printing {
 class PrinterQuery;
 class PrintJobManager;
@@ -105,6 +109,7 @@ class PrintingMessageFilter : public content::BrowserMessageFilter {
                              IPC::Message* reply_msg);
   void OnUpdatePrintSettingsReply(
       scoped_refptr<printing::PrinterQuery> printer_query,
+      const gfx::Size& page_size_microns,
       IPC::Message* reply_msg);
 
   // Check to see if print preview has been cancelled.
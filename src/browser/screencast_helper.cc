@@ -0,0 +1,424 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/screencast_helper.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/sequenced_task_runner.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "base/values.h"
+#include "content/nw/src/api/api_messages.h"
+#include "content/nw/src/nw_shell.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_source.h"
+#include "content/public/browser/notification_types.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "content/public/browser/web_contents.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/rect.h"
+
+using content::BrowserThread;
+
+namespace nw {
+
+namespace {
+
+const char kMaxFpsKey[] = "maxFps";
+const char kMaxPendingFramesKey[] = "maxPendingFrames";
+const char kKeyframeIntervalKey[] = "keyframeInterval";
+
+const int kDefaultMaxFps = 10;
+const int kDefaultMaxPendingFrames = 2;
+const int kDefaultKeyframeIntervalMs = 5000;
+
+// Frames are compared in square blocks of this many pixels.
+const int kDamageBlockSize = 32;
+
+// Above this share of changed pixels a keyframe is cheaper than the rects.
+const double kMaxDamageRatio = 0.5;
+
+bool BlockChanged(const SkBitmap& current,
+                  const SkBitmap& previous,
+                  const gfx::Rect& block) {
+  const size_t row_bytes = block.width() * sizeof(uint32_t);
+  for (int y = block.y(); y < block.bottom(); ++y) {
+    if (memcmp(current.getAddr32(block.x(), y),
+               previous.getAddr32(block.x(), y), row_bytes) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Compares |current| with |previous|, which have the same size, block by
+// block and merges the changed blocks into rectangles: runs of blocks within
+// a block row first, then runs of the same width in consecutive rows.
+void ComputeDamage(const SkBitmap& current,
+                   const SkBitmap& previous,
+                   std::vector<gfx::Rect>* damage) {
+  const gfx::Rect bounds(current.width(), current.height());
+  const int columns = (current.width() + kDamageBlockSize - 1) /
+      kDamageBlockSize;
+  const int rows = (current.height() + kDamageBlockSize - 1) /
+      kDamageBlockSize;
+
+  // Rectangles that touch the previous block row and may still grow.
+  std::vector<gfx::Rect> open;
+  for (int row = 0; row < rows; ++row) {
+    std::vector<gfx::Rect> next_open;
+    int column = 0;
+    while (column < columns) {
+      gfx::Rect block(column * kDamageBlockSize, row * kDamageBlockSize,
+                      kDamageBlockSize, kDamageBlockSize);
+      block.Intersect(bounds);
+      if (!BlockChanged(current, previous, block)) {
+        ++column;
+        continue;
+      }
+      gfx::Rect span = block;
+      for (++column; column < columns; ++column) {
+        gfx::Rect next(column * kDamageBlockSize, row * kDamageBlockSize,
+                       kDamageBlockSize, kDamageBlockSize);
+        next.Intersect(bounds);
+        if (!BlockChanged(current, previous, next))
+          break;
+        span.Union(next);
+      }
+
+      std::vector<gfx::Rect>::iterator it = open.begin();
+      for (; it != open.end(); ++it) {
+        if (it->x() == span.x() && it->width() == span.width())
+          break;
+      }
+      if (it != open.end()) {
+        span.Union(*it);
+        open.erase(it);
+      }
+      next_open.push_back(span);
+    }
+    damage->insert(damage->end(), open.begin(), open.end());
+    open.swap(next_open);
+  }
+  damage->insert(damage->end(), open.begin(), open.end());
+}
+
+}  // namespace
+
+struct ScreencastHelper::Frame {
+  Frame() : keyframe(false), succeeded(false) {}
+
+  bool keyframe;
+  gfx::Size size;
+  std::vector<gfx::Rect> rects;
+  std::vector<std::string> data;
+  bool succeeded;
+};
+
+// Owns the previous frame and encodes damage on a sequenced runner of the
+// blocking pool, so the UI thread never touches pixels.
+class ScreencastHelper::Encoder
+    : public base::RefCountedThreadSafe<ScreencastHelper::Encoder> {
+ public:
+  explicit Encoder(const CapturePageHelper::Options& options)
+      : options_(options) {
+    base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+    task_runner_ = pool->GetSequencedTaskRunnerWithShutdownBehavior(
+        pool->GetSequenceToken(),
+        base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  }
+
+  base::SequencedTaskRunner* task_runner() const { return task_runner_; }
+
+  // Encodes what changed in |bitmap| since the last call into |frame| and
+  // keeps |bitmap| for the next comparison.
+  void EncodeFrame(SkBitmap* bitmap, bool keyframe, Frame* frame) {
+    const gfx::Rect bounds(bitmap->width(), bitmap->height());
+    SkAutoLockPixels bitmap_lock(*bitmap);
+
+    if (previous_.isNull() || previous_.width() != bitmap->width() ||
+        previous_.height() != bitmap->height()) {
+      keyframe = true;
+    }
+
+    if (!keyframe) {
+      SkAutoLockPixels previous_lock(previous_);
+      ComputeDamage(*bitmap, previous_, &frame->rects);
+      int64 damaged_area = 0;
+      for (size_t i = 0; i < frame->rects.size(); ++i)
+        damaged_area += frame->rects[i].width() * frame->rects[i].height();
+      if (damaged_area > kMaxDamageRatio * bounds.width() * bounds.height())
+        keyframe = true;
+    }
+    if (keyframe) {
+      frame->rects.clear();
+      frame->rects.push_back(bounds);
+    }
+
+    frame->keyframe = keyframe;
+    frame->size = bounds.size();
+    for (size_t i = 0; i < frame->rects.size(); ++i) {
+      const gfx::Rect& rect = frame->rects[i];
+      SkBitmap subset;
+      if (!bitmap->extractSubset(&subset, SkIRect::MakeXYWH(
+              rect.x(), rect.y(), rect.width(), rect.height()))) {
+        return;
+      }
+      std::vector<unsigned char> encoded;
+      std::string mime_type;
+      if (!CapturePageHelper::EncodeImage(options_, subset, &encoded,
+                                          &mime_type)) {
+        return;
+      }
+      frame->data.push_back(CapturePageHelper::ToDataUrl(mime_type, encoded));
+    }
+
+    previous_.swap(*bitmap);
+    frame->succeeded = true;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<ScreencastHelper::Encoder>;
+  ~Encoder() {}
+
+  CapturePageHelper::Options options_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  // Only used on |task_runner_|.
+  SkBitmap previous_;
+
+  DISALLOW_COPY_AND_ASSIGN(Encoder);
+};
+
+ScreencastHelper::Options::Options()
+    : max_fps(kDefaultMaxFps),
+      max_pending_frames(kDefaultMaxPendingFrames),
+      keyframe_interval(
+          base::TimeDelta::FromMilliseconds(kDefaultKeyframeIntervalMs)) {
+}
+
+// static
+scoped_refptr<ScreencastHelper> ScreencastHelper::Create(
+    content::Shell* shell) {
+  return make_scoped_refptr(new ScreencastHelper(shell));
+}
+
+ScreencastHelper::ScreencastHelper(content::Shell* shell)
+    : content::WebContentsObserver(shell->web_contents()),
+      shell_(shell),
+      running_(false),
+      generation_(0),
+      dirty_(false),
+      keyframe_needed_(false),
+      capture_in_flight_(false),
+      next_sequence_(1),
+      last_acked_sequence_(0) {
+}
+
+ScreencastHelper::~ScreencastHelper() {
+}
+
+void ScreencastHelper::Start(const base::DictionaryValue& options_value) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  Stop();
+
+  Options options;
+  if (!CapturePageHelper::ParseOptions(options_value, &options.encoder))
+    return;
+  // Every rect is sent inline with its frame.
+  options.encoder.data_type = CapturePageHelper::DATA_TYPE_DATA_URL;
+  if (options_value.GetInteger(kMaxFpsKey, &options.max_fps))
+    options.max_fps = std::max(1, std::min(options.max_fps, 60));
+  if (options_value.GetInteger(kMaxPendingFramesKey,
+                               &options.max_pending_frames)) {
+    options.max_pending_frames = std::max(1, options.max_pending_frames);
+  }
+  int keyframe_interval_ms;
+  if (options_value.GetInteger(kKeyframeIntervalKey, &keyframe_interval_ms)) {
+    options.keyframe_interval = base::TimeDelta::FromMilliseconds(
+        std::max(100, keyframe_interval_ms));
+  }
+
+  options_ = options;
+  encoder_ = new Encoder(options.encoder);
+  running_ = true;
+  dirty_ = true;
+  keyframe_needed_ = true;
+  last_acked_sequence_ = next_sequence_ - 1;
+
+  registrar_.Add(this,
+                 content::NOTIFICATION_RENDER_WIDGET_HOST_DID_UPDATE_BACKING_STORE,
+                 content::NotificationService::AllSources());
+  keyframe_timer_.Start(FROM_HERE, options_.keyframe_interval, this,
+                        &ScreencastHelper::ForceKeyframe);
+  MaybeCaptureFrame();
+}
+
+void ScreencastHelper::Stop() {
+  if (!running_)
+    return;
+  running_ = false;
+  ++generation_;
+  capture_in_flight_ = false;
+  encoder_ = NULL;
+  registrar_.RemoveAll();
+  throttle_timer_.Stop();
+  keyframe_timer_.Stop();
+}
+
+void ScreencastHelper::AckFrame(int sequence) {
+  last_acked_sequence_ = std::max(last_acked_sequence_, sequence);
+  MaybeCaptureFrame();
+}
+
+void ScreencastHelper::Observe(int type,
+                               const content::NotificationSource& source,
+                               const content::NotificationDetails& details) {
+  DCHECK_EQ(content::NOTIFICATION_RENDER_WIDGET_HOST_DID_UPDATE_BACKING_STORE,
+            type);
+  if (!web_contents())
+    return;
+  content::RenderWidgetHost* widget =
+      content::Source<content::RenderWidgetHost>(source).ptr();
+  if (widget != web_contents()->GetRenderViewHost())
+    return;
+
+  dirty_ = true;
+  MaybeCaptureFrame();
+}
+
+void ScreencastHelper::WebContentsDestroyed(
+    content::WebContents* web_contents) {
+  Stop();
+}
+
+void ScreencastHelper::MaybeCaptureFrame() {
+  if (!running_ || !dirty_ || capture_in_flight_ ||
+      throttle_timer_.IsRunning() || !web_contents()) {
+    return;
+  }
+
+  // Backpressure: wait for the page to catch up.
+  if (next_sequence_ - 1 - last_acked_sequence_ >= options_.max_pending_frames)
+    return;
+
+  const base::TimeDelta min_interval = base::TimeDelta::FromMicroseconds(
+      base::Time::kMicrosecondsPerSecond / options_.max_fps);
+  const base::TimeDelta elapsed =
+      base::TimeTicks::Now() - last_capture_time_;
+  if (elapsed < min_interval) {
+    throttle_timer_.Start(FROM_HERE, min_interval - elapsed, this,
+                          &ScreencastHelper::MaybeCaptureFrame);
+    return;
+  }
+
+  content::RenderViewHost* render_view_host =
+      web_contents()->GetRenderViewHost();
+  content::RenderWidgetHostView* view = render_view_host->GetView();
+  if (!view)
+    return;
+
+  const bool keyframe = keyframe_needed_;
+  dirty_ = false;
+  keyframe_needed_ = false;
+  capture_in_flight_ = true;
+  last_capture_time_ = base::TimeTicks::Now();
+  render_view_host->CopyFromBackingStore(
+      gfx::Rect(),
+      view->GetViewBounds().size(),
+      base::Bind(&ScreencastHelper::CopyFromBackingStoreComplete, this,
+                 generation_, keyframe));
+}
+
+void ScreencastHelper::ForceKeyframe() {
+  keyframe_needed_ = true;
+  dirty_ = true;
+  MaybeCaptureFrame();
+}
+
+void ScreencastHelper::CopyFromBackingStoreComplete(int generation,
+                                                    bool keyframe,
+                                                    bool succeeded,
+                                                    const SkBitmap& bitmap) {
+  if (generation != generation_)
+    return;
+
+  SkBitmap* copy = new SkBitmap;
+  if (!succeeded || !bitmap.copyTo(copy, SkBitmap::kARGB_8888_Config)) {
+    delete copy;
+    capture_in_flight_ = false;
+    keyframe_needed_ |= keyframe;
+    return;
+  }
+
+  Frame* frame = new Frame;
+  encoder_->task_runner()->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&Encoder::EncodeFrame, encoder_, base::Owned(copy),
+                 keyframe, frame),
+      base::Bind(&ScreencastHelper::SendFrame, this, generation,
+                 base::Owned(frame)));
+}
+
+void ScreencastHelper::SendFrame(int generation, Frame* frame) {
+  if (generation != generation_)
+    return;
+  capture_in_flight_ = false;
+
+  if (!web_contents() || shell_->id() < 0)
+    return;
+
+  // Nothing changed, so there is nothing to send.
+  if (frame->succeeded && !frame->rects.empty()) {
+    base::DictionaryValue* value = new base::DictionaryValue;
+    value->SetInteger("sequence", next_sequence_++);
+    value->SetBoolean("keyframe", frame->keyframe);
+    value->SetInteger("width", frame->size.width());
+    value->SetInteger("height", frame->size.height());
+    value->SetDouble("timestamp", base::Time::Now().ToJsTime());
+    base::ListValue* rects = new base::ListValue;
+    for (size_t i = 0; i < frame->rects.size(); ++i) {
+      base::DictionaryValue* rect = new base::DictionaryValue;
+      rect->SetInteger("x", frame->rects[i].x());
+      rect->SetInteger("y", frame->rects[i].y());
+      rect->SetInteger("width", frame->rects[i].width());
+      rect->SetInteger("height", frame->rects[i].height());
+      rect->SetString("data", frame->data[i]);
+      rects->Append(rect);
+    }
+    value->Set("rects", rects);
+
+    base::ListValue args;
+    args.Append(value);
+    Send(new ShellViewMsg_Object_On_Event(routing_id(), shell_->id(),
+                                          "screencastframe", args));
+  } else if (!frame->succeeded) {
+    keyframe_needed_ = true;
+  }
+
+  MaybeCaptureFrame();
+}
+
+}  // namespace nw
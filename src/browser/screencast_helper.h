@@ -0,0 +1,130 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_BROWSER_SCREENCAST_HELPER_H_
+#define CONTENT_NW_SRC_BROWSER_SCREENCAST_HELPER_H_
+
+#include "base/memory/ref_counted.h"
+#include "base/time.h"
+#include "base/timer.h"
+#include "content/nw/src/browser/capture_page_helper.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
+#include "content/public/browser/web_contents_observer.h"
+
+namespace base {
+class DictionaryValue;
+class SequencedTaskRunner;
+}
+
+namespace content {
+class Shell;
+}
+
+class SkBitmap;
+
+namespace nw {
+
+// Streams the content of a window as "screencastframe" events. A frame is
+// only grabbed after the renderer painted, at most |max_fps| times a second,
+// and only the rectangles that differ from the previous frame are encoded.
+// A full keyframe is sent first, on resize, and every |keyframe_interval|.
+// The page acknowledges each frame; while |max_pending_frames| are
+// unacknowledged no new frame is grabbed, so a slow consumer lowers the
+// frame rate instead of queueing frames.
+class ScreencastHelper : public base::RefCountedThreadSafe<ScreencastHelper>,
+                         public content::WebContentsObserver,
+                         public content::NotificationObserver {
+ public:
+  struct Options {
+    Options();
+
+    CapturePageHelper::Options encoder;
+    int max_fps;
+    int max_pending_frames;
+    base::TimeDelta keyframe_interval;
+  };
+
+  // The encoded output of one frame, filled in on the encoder sequence.
+  struct Frame;
+
+  static scoped_refptr<ScreencastHelper> Create(content::Shell* shell);
+
+  // |options| may hold the capturePage format keys plus "maxFps",
+  // "maxPendingFrames" and "keyframeInterval" (in ms). Restarts the
+  // screencast if one is running.
+  void Start(const base::DictionaryValue& options);
+  void Stop();
+
+  // The page is done with frame |sequence|.
+  void AckFrame(int sequence);
+
+ private:
+  class Encoder;
+  friend class base::RefCountedThreadSafe<ScreencastHelper>;
+
+  explicit ScreencastHelper(content::Shell* shell);
+  virtual ~ScreencastHelper();
+
+  // content::NotificationObserver implementation.
+  virtual void Observe(int type,
+                       const content::NotificationSource& source,
+                       const content::NotificationDetails& details) OVERRIDE;
+
+  // content::WebContentsObserver implementation.
+  virtual void WebContentsDestroyed(content::WebContents* web_contents)
+      OVERRIDE;
+
+  // Grabs a frame if one is due and allowed, or schedules one for later.
+  void MaybeCaptureFrame();
+  void ForceKeyframe();
+  void CopyFromBackingStoreComplete(int generation,
+                                    bool keyframe,
+                                    bool succeeded,
+                                    const SkBitmap& bitmap);
+  void SendFrame(int generation, Frame* frame);
+
+  content::Shell* shell_;
+  content::NotificationRegistrar registrar_;
+
+  bool running_;
+  // Bumped on every Start() and Stop() so late replies of an earlier
+  // screencast are dropped.
+  int generation_;
+  Options options_;
+  scoped_refptr<Encoder> encoder_;
+
+  // Something was painted since the last grabbed frame.
+  bool dirty_;
+  bool keyframe_needed_;
+  bool capture_in_flight_;
+  int next_sequence_;
+  int last_acked_sequence_;
+  base::TimeTicks last_capture_time_;
+
+  base::OneShotTimer<ScreencastHelper> throttle_timer_;
+  base::RepeatingTimer<ScreencastHelper> keyframe_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScreencastHelper);
+};
+
+}  // namespace nw
+
+#endif  // CONTENT_NW_SRC_BROWSER_SCREENCAST_HELPER_H_
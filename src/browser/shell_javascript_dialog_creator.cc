@@ -25,12 +25,24 @@
 #include "base/utf_string_conversions.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/web_contents_view.h"
+#include "content/nw/src/browser/native_window.h"
 #include "content/nw/src/browser/shell_javascript_dialog.h"
 #include "content/nw/src/common/shell_switches.h"
+#include "content/nw/src/nw_shell.h"
 #include "net/base/net_util.h"
 
 namespace content {
 
+namespace {
+
+// Nobody could answer a dialog of a window that is not on screen.
+bool IsHeadless(WebContents* web_contents) {
+  Shell* shell = Shell::FromRenderViewHost(web_contents->GetRenderViewHost());
+  return shell && shell->window() && shell->window()->IsHeadless();
+}
+
+}  // namespace
+
 ShellJavaScriptDialogCreator::ShellJavaScriptDialogCreator() {
 }
 
@@ -53,6 +65,11 @@ void ShellJavaScriptDialogCreator::RunJavaScriptDialog(
     return;
   }
 
+  if (IsHeadless(web_contents)) {
+    *did_suppress_message = true;
+    return;
+  }
+
 #if defined(OS_MACOSX) || defined(OS_WIN) || defined(TOOLKIT_GTK)
   *did_suppress_message = false;
 
@@ -90,6 +107,11 @@ void ShellJavaScriptDialogCreator::RunBeforeUnloadDialog(
     return;
   }
 
+  if (IsHeadless(web_contents)) {
+    callback.Run(true, string16());
+    return;
+  }
+
 #if defined(OS_MACOSX) || defined(OS_WIN) || defined(TOOLKIT_GTK)
   if (dialog_.get()) {
     // Seriously!?
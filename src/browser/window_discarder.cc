@@ -0,0 +1,170 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/window_discarder.h"
+
+#include <algorithm>
+
+#include "base/values.h"
+#include "content/nw/src/api/api_messages.h"
+#include "content/nw/src/common/shell_switches.h"
+#include "content/nw/src/nw_shell.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/common/page_transition_types.h"
+#include "content/public/common/referrer.h"
+
+namespace nw {
+
+namespace {
+
+const char kPlaceholderURL[] = "about:blank";
+
+}  // namespace
+
+WindowDiscarder::WindowDiscarder(content::Shell* shell,
+                                 base::DictionaryValue* manifest)
+    : content::WebContentsObserver(shell->web_contents()),
+      shell_(shell),
+      timeout_(0),
+      hidden_(false),
+      state_(STATE_LIVE),
+      waiting_for_revive_(false) {
+  int seconds = 0;
+  if (manifest->GetInteger(switches::kmDiscardAfter, &seconds))
+    timeout_ = std::max(seconds, 0);
+  bool show = true;
+  manifest->GetBoolean(switches::kmShow, &show);
+  SetHidden(!show);
+}
+
+WindowDiscarder::~WindowDiscarder() {
+}
+
+void WindowDiscarder::SetTimeout(int seconds) {
+  timeout_ = std::max(seconds, 0);
+  timer_.Stop();
+  if (hidden_)
+    StartTimer();
+}
+
+void WindowDiscarder::SetHidden(bool hidden) {
+  hidden_ = hidden;
+  timer_.Stop();
+  if (hidden_)
+    StartTimer();
+  else
+    Restore();
+}
+
+void WindowDiscarder::StartTimer() {
+  if (timeout_ > 0 && state_ == STATE_LIVE) {
+    timer_.Start(FROM_HERE, base::TimeDelta::FromSeconds(timeout_),
+                 this, &WindowDiscarder::Discard);
+  }
+}
+
+void WindowDiscarder::Discard() {
+  if (!hidden_ || state_ != STATE_LIVE || shell_->is_devtools() ||
+      !web_contents())
+    return;
+
+  content::NavigationController& controller = web_contents()->GetController();
+  content::NavigationEntry* entry = controller.GetLastCommittedEntry();
+  if (!entry || entry->GetURL() == GURL(kPlaceholderURL))
+    return;
+
+  // IPC keeps the order, so the page handles the event before it unloads.
+  shell_->SendEvent("discard");
+
+  discarded_url_ = entry->GetURL();
+  state_ = STATE_DISCARDING;
+  controller.LoadURL(GURL(kPlaceholderURL),
+                     content::Referrer(),
+                     content::PAGE_TRANSITION_AUTO_TOPLEVEL,
+                     std::string());
+}
+
+void WindowDiscarder::Restore() {
+  if (state_ == STATE_DISCARDING) {
+    // The placeholder has not replaced the page yet; keep the page.
+    web_contents()->Stop();
+    state_ = STATE_LIVE;
+    shell_->SendEvent("revive");
+    return;
+  }
+  if (state_ != STATE_DISCARDED)
+    return;
+
+  content::NavigationController& controller = web_contents()->GetController();
+  state_ = STATE_RESTORING;
+  if (controller.CanGoBack()) {
+    controller.GoBack();
+  } else {
+    controller.LoadURL(discarded_url_,
+                       content::Referrer(),
+                       content::PAGE_TRANSITION_AUTO_TOPLEVEL,
+                       std::string());
+  }
+}
+
+void WindowDiscarder::DidNavigateMainFrame(
+    const content::LoadCommittedDetails& details,
+    const content::FrameNavigateParams& params) {
+  content::NavigationController& controller = web_contents()->GetController();
+  switch (state_) {
+    case STATE_DISCARDING:
+      state_ = STATE_DISCARDED;
+      // Drop the memory cache so the page's decoded resources go with it.
+      // The cache is per process, so other windows sharing the renderer
+      // lose their cached resources too.
+      web_contents()->GetRenderProcessHost()->Send(
+          new ShellViewMsg_ClearCache());
+      break;
+    case STATE_RESTORING: {
+      state_ = STATE_LIVE;
+      waiting_for_revive_ = true;
+      // Drop the placeholder, now the entry after the current one.
+      int placeholder = controller.GetLastCommittedEntryIndex() + 1;
+      if (placeholder < controller.GetEntryCount() &&
+          controller.GetEntryAtIndex(placeholder)->GetURL() ==
+              GURL(kPlaceholderURL)) {
+        controller.RemoveEntryAtIndex(placeholder);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void WindowDiscarder::DidStopLoading(
+    content::RenderViewHost* render_view_host) {
+  if (!waiting_for_revive_)
+    return;
+  waiting_for_revive_ = false;
+  shell_->SendEvent("revive");
+  if (hidden_)
+    StartTimer();
+}
+
+}  // namespace nw
@@ -0,0 +1,107 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_BROWSER_WINDOW_DISCARDER_H_
+#define CONTENT_NW_SRC_BROWSER_WINDOW_DISCARDER_H_
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/timer.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "googleurl/src/gurl.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace content {
+class Shell;
+}
+
+namespace nw {
+
+// Drops the page of a window that has stayed hidden for |timeout| seconds
+// and brings it back when the window is shown again.
+//
+// The page is discarded by navigating to a blank placeholder, which frees
+// its DOM, JavaScript heap and decoded resources; the Shell, the native
+// window and the app's Window object are kept. Showing the window goes back
+// in history, so the page is reloaded with the scroll position and form
+// state WebKit saved in the history entry, and the placeholder is dropped
+// from the history again.
+//
+// The page gets a "discard" event right before it is dropped, to save its
+// own state, and a "revive" event once it has loaded again.
+//
+// Off by default; the "discard-after" field of the window manifest sets the
+// initial timeout.
+class WindowDiscarder : public content::WebContentsObserver {
+ public:
+  WindowDiscarder(content::Shell* shell, base::DictionaryValue* manifest);
+  virtual ~WindowDiscarder();
+
+  // |seconds| of 0 turns discarding off.
+  void SetTimeout(int seconds);
+
+  // Window visibility reported by the Window API.
+  void SetHidden(bool hidden);
+
+  // Discards the page right away if the window is hidden.
+  void Discard();
+
+  bool is_discarded() const { return state_ != STATE_LIVE; }
+
+ private:
+  enum State {
+    STATE_LIVE,
+    STATE_DISCARDING,  // Waiting for the placeholder to commit.
+    STATE_DISCARDED,
+    STATE_RESTORING    // Waiting for the page to commit again.
+  };
+
+  // content::WebContentsObserver implementation.
+  virtual void DidNavigateMainFrame(
+      const content::LoadCommittedDetails& details,
+      const content::FrameNavigateParams& params) OVERRIDE;
+  virtual void DidStopLoading(
+      content::RenderViewHost* render_view_host) OVERRIDE;
+
+  void Restore();
+  void StartTimer();
+
+  content::Shell* shell_;
+  int timeout_;
+  bool hidden_;
+  State state_;
+
+  // Page to go back to if the history entry is gone.
+  GURL discarded_url_;
+
+  // Set between the restoring commit and the end of the load.
+  bool waiting_for_revive_;
+
+  base::OneShotTimer<WindowDiscarder> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(WindowDiscarder);
+};
+
+}  // namespace nw
+
+#endif  // CONTENT_NW_SRC_BROWSER_WINDOW_DISCARDER_H_
@@ -0,0 +1,122 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/browser/window_throttler.h"
+
+#include <algorithm>
+
+#include "base/values.h"
+#include "content/nw/src/common/shell_switches.h"
+#include "content/nw/src/renderer/common/render_messages.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/web_contents.h"
+
+namespace nw {
+
+namespace {
+
+// Anything above this is no cap at all for a 60Hz display.
+const int kMaxFrameRate = 60;
+
+}  // namespace
+
+WindowThrottler::WindowThrottler(content::WebContents* web_contents,
+                                 base::DictionaryValue* manifest)
+    : content::WebContentsObserver(web_contents),
+      max_fps_(0),
+      background_throttling_(false),
+      hidden_(false),
+      minimized_(false),
+      occluded_(false),
+      throttled_(false) {
+  int fps = 0;
+  if (manifest->GetInteger(switches::kmMaxFps, &fps))
+    max_fps_ = std::max(0, std::min(fps, kMaxFrameRate));
+  manifest->GetBoolean(switches::kmBackgroundThrottling,
+                       &background_throttling_);
+  bool show = true;
+  manifest->GetBoolean(switches::kmShow, &show);
+  hidden_ = !show;
+}
+
+WindowThrottler::~WindowThrottler() {
+}
+
+void WindowThrottler::SetMaxFps(int fps) {
+  fps = std::max(0, std::min(fps, kMaxFrameRate));
+  if (fps == max_fps_)
+    return;
+  max_fps_ = fps;
+  if (web_contents())
+    SendMaxFps(web_contents()->GetRenderViewHost());
+}
+
+void WindowThrottler::SetBackgroundThrottling(bool enabled) {
+  background_throttling_ = enabled;
+  UpdateThrottling();
+}
+
+void WindowThrottler::SetHidden(bool hidden) {
+  hidden_ = hidden;
+  UpdateThrottling();
+}
+
+void WindowThrottler::SetMinimized(bool minimized) {
+  minimized_ = minimized;
+  UpdateThrottling();
+}
+
+void WindowThrottler::SetOccluded(bool occluded) {
+  occluded_ = occluded;
+  UpdateThrottling();
+}
+
+void WindowThrottler::RenderViewCreated(
+    content::RenderViewHost* render_view_host) {
+  // A new renderer starts without a cap.
+  if (max_fps_ > 0)
+    SendMaxFps(render_view_host);
+  // The first view can only be hidden once it exists.
+  UpdateThrottling();
+}
+
+void WindowThrottler::SendMaxFps(content::RenderViewHost* render_view_host) {
+  if (!render_view_host)
+    return;
+  render_view_host->Send(new NwViewMsg_SetMaxFrameRate(
+      render_view_host->GetRoutingID(), max_fps_));
+}
+
+void WindowThrottler::UpdateThrottling() {
+  bool throttle =
+      background_throttling_ && (hidden_ || minimized_ || occluded_);
+  if (throttle == throttled_ || !web_contents())
+    return;
+  throttled_ = throttle;
+
+  // This is what a background tab goes through: the renderer stops
+  // painting and clamps its timers.
+  if (throttled_)
+    web_contents()->WasHidden();
+  else
+    web_contents()->WasShown();
+}
+
+}  // namespace nw
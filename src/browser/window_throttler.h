@@ -0,0 +1,88 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_BROWSER_WINDOW_THROTTLER_H_
+#define CONTENT_NW_SRC_BROWSER_WINDOW_THROTTLER_H_
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "content/public/browser/web_contents_observer.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace nw {
+
+// Limits how much work the page of one window does.
+//
+// A frame rate cap delays requestAnimationFrame callbacks of the top frame
+// so they run at most |max_fps| times a second. Nothing else is capped.
+//
+// With background throttling the page is treated like a background tab
+// while its window is hidden, minimized or occluded: it stops painting,
+// requestAnimationFrame stops firing, timers run at most once a second and
+// document.webkitHidden is true. Only the GTK window reports occlusion, and
+// only under a non-compositing window manager.
+//
+// Both default to the "max-fps" and "background-throttling" fields of the
+// window manifest.
+class WindowThrottler : public content::WebContentsObserver {
+ public:
+  WindowThrottler(content::WebContents* web_contents,
+                  base::DictionaryValue* manifest);
+  virtual ~WindowThrottler();
+
+  // |fps| of 0 removes the cap.
+  void SetMaxFps(int fps);
+  int max_fps() const { return max_fps_; }
+
+  void SetBackgroundThrottling(bool enabled);
+  bool background_throttling() const { return background_throttling_; }
+
+  // Window state reported by the native window.
+  void SetHidden(bool hidden);
+  void SetMinimized(bool minimized);
+  void SetOccluded(bool occluded);
+
+  bool is_throttled() const { return throttled_; }
+
+ private:
+  // content::WebContentsObserver implementation.
+  virtual void RenderViewCreated(
+      content::RenderViewHost* render_view_host) OVERRIDE;
+
+  void SendMaxFps(content::RenderViewHost* render_view_host);
+  void UpdateThrottling();
+
+  int max_fps_;
+  bool background_throttling_;
+
+  bool hidden_;
+  bool minimized_;
+  bool occluded_;
+  bool throttled_;
+
+  DISALLOW_COPY_AND_ASSIGN(WindowThrottler);
+};
+
+}  // namespace nw
+
+#endif  // CONTENT_NW_SRC_BROWSER_WINDOW_THROTTLER_H_
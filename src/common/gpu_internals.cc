@@ -410,6 +410,59 @@ Value* GetFeatureStatus() {
   return status;
 }
 
+ListValue* GetRasterizationInfo() {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  bool impl_side_painting =
+      command_line.HasSwitch(cc::switches::kEnableImplSidePainting);
+  int raster_threads = 1;
+  if (command_line.HasSwitch(cc::switches::kNumRasterThreads)) {
+    base::StringToInt(
+        command_line.GetSwitchValueASCII(cc::switches::kNumRasterThreads),
+        &raster_threads);
+  }
+  GpuDataManager* gpu_data_manager = GpuDataManager::GetInstance();
+
+  // Raster threads only serve pages drawn by the cc compositor. Without
+  // accelerated compositing, which headless mode and --disable-gpu turn
+  // off, WebKit paints every page on the renderer main thread whatever the
+  // switches say.
+  std::string compositing;
+  if (command_line.HasSwitch(switches::kDisableAcceleratedCompositing))
+    compositing = "Off";
+  else if (gpu_data_manager->ShouldUseSoftwareRendering())
+    compositing = "SwiftShader";
+  else if (!gpu_data_manager->GpuAccessAllowed() ||
+           (gpu_data_manager->GetBlacklistedFeatures() &
+            content::GPU_FEATURE_TYPE_ACCELERATED_COMPOSITING))
+    compositing = "Off";
+  else
+    compositing = "GPU";
+
+  std::string rasterization = "Software, renderer main thread";
+  if (compositing != "Off" && impl_side_painting) {
+    rasterization =
+        base::StringPrintf("Software, %d raster thread(s)", raster_threads);
+    // Without force compositing only pages with composited layers get
+    // there.
+    if (!content::IsForceCompositingModeEnabled())
+      rasterization += " for composited pages";
+  }
+
+  ListValue* raster_info = new ListValue();
+  raster_info->Append(NewDescriptionValuePair(
+      "Impl-side painting", Value::CreateBooleanValue(impl_side_painting)));
+  raster_info->Append(NewDescriptionValuePair("Rasterization", rasterization));
+  raster_info->Append(NewDescriptionValuePair(
+      "Threaded compositing",
+      Value::CreateBooleanValue(content::IsThreadedCompositingEnabled())));
+  raster_info->Append(NewDescriptionValuePair(
+      "Accelerated compositing", compositing));
+  raster_info->Append(NewDescriptionValuePair(
+      "CPU cores",
+      base::IntToString(base::SysInfo::NumberOfProcessors())));
+  return raster_info;
+}
+
 }  // namespace
 
 void PrintGpuInfo() {
@@ -444,3 +497,10 @@ void PrintClientInfo() {
 
   delete dict;
 }
+
+base::DictionaryValue* GetGpuInternalsInfo() {
+  base::DictionaryValue* info = GpuInfoAsDictionaryValue();
+  info->Set("featureStatus", GetFeatureStatus());
+  info->Set("rasterization", GetRasterizationInfo());
+  return info;
+}
@@ -21,7 +21,16 @@
 #ifndef CONTENT_NW_SRC_COMMON_GPU_INTERNALS_H_
 #define CONTENT_NW_SRC_COMMON_GPU_INTERNALS_H_
 
+namespace base {
+class DictionaryValue;
+}
+
 void PrintGpuInfo();
 void PrintClientInfo();
 
+// Returns what the nw:gpu page shows: "basic_info", "featureStatus" and
+// "rasterization", the last one describing where pages are rasterized.
+// The caller owns the result.
+base::DictionaryValue* GetGpuInternalsInfo();
+
 #endif  // CONTENT_NW_SRC_COMMON_GPU_INTERNALS_H_
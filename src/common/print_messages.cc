@@ -8,6 +8,12 @@
 #include "base/string16.h"
 #include "ui/gfx/size.h"
 
+namespace printing {
+
+const char kSettingPageSizeMicrons[] = "pageSizeMicrons";
+
+}  // namespace printing
+
 PrintMsg_Print_Params::PrintMsg_Print_Params()
   : page_size(),
     content_size(),
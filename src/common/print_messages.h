@@ -10,6 +10,7 @@
 
 #include "base/values.h"
 #include "base/shared_memory.h"
+#include "base/time.h"
 #include "ipc/ipc_message_macros.h"
 #include "printing/page_size_margins.h"
 #include "printing/print_job_constants.h"
@@ -71,6 +72,14 @@ struct PrintHostMsg_RequestPrintPreview_Params {
   bool selection_only;
 };
 
+namespace printing {
+
+// Paper size of a PDF job as a dictionary with "width" and "height" in
+// microns. Without it the PDF printer uses the locale's default paper.
+extern const char kSettingPageSizeMicrons[];
+
+}  // namespace printing
+
 #endif  // CHROME_COMMON_PRINT_MESSAGES_H_
 
 #define IPC_MESSAGE_START PrintMsgStart
@@ -208,6 +217,12 @@ IPC_STRUCT_BEGIN(PrintHostMsg_DidPreviewDocument_Params)
 
   // The id of the preview request.
   IPC_STRUCT_MEMBER(int, preview_request_id)
+
+  // How long the renderer spent laying out and counting the pages,
+  // rendering them, and finishing the metafile.
+  IPC_STRUCT_MEMBER(base::TimeDelta, layout_time)
+  IPC_STRUCT_MEMBER(base::TimeDelta, render_time)
+  IPC_STRUCT_MEMBER(base::TimeDelta, finalize_time)
 IPC_STRUCT_END()
 
 // Parameters to describe a rendered preview page.
@@ -287,6 +302,12 @@ IPC_MESSAGE_ROUTED1(PrintMsg_InitiatePrintPreview, bool /* selection_only */)
 // node, depending on which mode the render view is in.
 IPC_MESSAGE_ROUTED0(PrintMsg_PrintNodeUnderContextMenu)
 
+// Tells the render view to render its main frame into a PDF document with
+// the print preview settings in |settings|, without showing print preview.
+// The result comes back in a PrintHostMsg_MetafileReadyForPrinting message.
+IPC_MESSAGE_ROUTED1(PrintMsg_PrintToPDF,
+                    DictionaryValue /* settings */)
+
 // Tells the renderer to print the print preview tab's PDF plugin without
 // showing the print dialog. (This is the final step in the print preview
 // workflow.)
@@ -297,8 +318,10 @@ IPC_MESSAGE_ROUTED1(PrintMsg_PrintForPrintPreview,
 // requested pages and switch back the CSS to display media type.
 IPC_MESSAGE_ROUTED0(PrintMsg_PrintPages)
 
-// Tells the render view that printing is done so it can clean up.
-IPC_MESSAGE_ROUTED1(PrintMsg_PrintingDone,
+// Tells the render view that printing of the document |document_cookie| is
+// done so it can clean up.
+IPC_MESSAGE_ROUTED2(PrintMsg_PrintingDone,
+                    int /* document_cookie */,
                     bool /* success */)
 
 // Tells the render view whether scripted printing is blocked or not.
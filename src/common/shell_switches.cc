@@ -44,6 +44,13 @@ const char kNodeMain[] = "node-main";
 const char kSnapshot[] = "snapshot";
 const char kDomStorageQuota[] = "ds-quota";
 
+// WebKit memory cache capacities in bytes, as
+// "min_dead_capacity,max_dead_capacity,capacity".
+const char kWebCacheCapacities[] = "webcache-capacities";
+
+// Run without any native window, rendering in software only.
+const char kHeadless[] = "headless";
+
 const char kmMain[]   = "main";
 const char kmName[]   = "name";
 const char kmWebkit[] = "webkit";
@@ -79,6 +86,27 @@ const char kmKiosk[] = "kiosk";
 // Make windows stays on the top of all other windows.
 const char kmAlwaysOnTop[] = "always-on-top";
 
+// Make the window headless: no native window, toolbar or menu is created.
+// As a top level field it makes every window headless, like --headless.
+const char kmHeadless[] = "headless";
+
+// Cap on the requestAnimationFrame rate of the top frame of the window, 0
+// for none. Nothing else about the page is slowed down.
+const char kmMaxFps[] = "max-fps";
+
+// Throttle the page like a background tab while the window is hidden,
+// minimized or occluded.
+const char kmBackgroundThrottling[] = "background-throttling";
+
+// Seconds a window may stay hidden before its page is discarded, 0 (the
+// default) to never discard.
+const char kmDiscardAfter[] = "discard-after";
+
+// Keep a shown window hidden until its page painted something, or at most
+// the timeout in milliseconds.
+const char kmShowAfterPaint[] = "show-after-paint";
+const char kmShowAfterPaintTimeout[] = "show-after-paint-timeout";
+
 // Whether we should support WebGL.
 const char kmWebgl[] = "webgl";
 
@@ -98,6 +126,28 @@ const char kmRemotePages[] = "node-remote";
 
 const char kmNewInstance[] = "new-instance";
 
+// Which backend keeps the cookies: "sqlite" (default) or "memory", which
+// keeps them in memory and writes periodic snapshots.
+const char kmCookieStore[] = "cookie-store";
+
+// Seconds between two snapshots of the "memory" cookie store.
+const char kmCookieSnapshotInterval[] = "cookie-snapshot-interval";
+
+// Capacities of the renderer's WebKit memory cache, in MB.
+const char kmWebCache[]        = "webcache";
+const char kmMinDeadCapacity[] = "min_dead_capacity";
+const char kmMaxDeadCapacity[] = "max_dead_capacity";
+const char kmCapacity[]        = "capacity";
+
+// Rasterization settings. With "impl-side-painting" pages are recorded on
+// the renderer main thread and rasterized in software on "threads" worker
+// threads of the compositor, one less than the number of cores by default.
+// It needs accelerated compositing: with headless mode, --disable-gpu or a
+// blacklisted GPU pages are still painted on the renderer main thread.
+const char kmRaster[]           = "raster";
+const char kmImplSidePainting[] = "impl-side-painting";
+const char kmRasterThreads[]    = "threads";
+
 #if defined(OS_WIN)
 // Enable conversion from vector to raster for any page.
 const char kPrintRaster[] = "print-raster";
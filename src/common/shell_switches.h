@@ -17,6 +17,8 @@ extern const char kWorkingDirectory[];
 extern const char kNodeMain[];
 extern const char kSnapshot[];
 extern const char kDomStorageQuota[];
+extern const char kWebCacheCapacities[];
+extern const char kHeadless[];
 
 // Manifest settings
 extern const char kmMain[];
@@ -47,6 +49,12 @@ extern const char kmAsDesktop[];
 extern const char kmFullscreen[];
 extern const char kmKiosk[];
 extern const char kmAlwaysOnTop[];
+extern const char kmHeadless[];
+extern const char kmMaxFps[];
+extern const char kmBackgroundThrottling[];
+extern const char kmDiscardAfter[];
+extern const char kmShowAfterPaint[];
+extern const char kmShowAfterPaintTimeout[];
 
 extern const char kmWebgl[];
 extern const char kmJava[];
@@ -55,6 +63,17 @@ extern const char kmPageCache[];
 extern const char kmUserAgent[];
 extern const char kmRemotePages[];
 extern const char kmNewInstance[];
+extern const char kmCookieStore[];
+extern const char kmCookieSnapshotInterval[];
+
+extern const char kmWebCache[];
+extern const char kmMinDeadCapacity[];
+extern const char kmMaxDeadCapacity[];
+extern const char kmCapacity[];
+
+extern const char kmRaster[];
+extern const char kmImplSidePainting[];
+extern const char kmRasterThreads[];
 
 #if defined(OS_WIN)
 extern const char kPrintRaster[];
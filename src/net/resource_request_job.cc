@@ -22,10 +22,15 @@
 
 #include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/json/json_writer.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop.h"
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/string_util.h"
+#include "base/values.h"
+#include "content/nw/src/common/gpu_internals.h"
 #include "googleurl/src/gurl.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
@@ -37,6 +42,29 @@
 
 namespace nw {
 
+namespace {
+
+// Placeholder of nw_gpu.html replaced with the GPU information as JSON.
+const char kGpuInfoPlaceholder[] = "$GPU_INFO";
+
+base::RefCountedMemory* BuildGpuPage() {
+  base::StringPiece page_template = ResourceBundle::GetSharedInstance().
+      GetRawDataResource(IDR_NW_GPU);
+  scoped_ptr<base::DictionaryValue> info(GetGpuInternalsInfo());
+  std::string json;
+  base::JSONWriter::Write(info.get(), &json);
+  // The JSON is spliced into a <script>; a driver or GL string holding
+  // "</script>" must not end it. '<' only occurs inside JSON strings.
+  ReplaceSubstringsAfterOffset(&json, 0, "<", "\\u003C");
+
+  std::string page;
+  page_template.CopyToString(&page);
+  ReplaceFirstSubstringAfterOffset(&page, 0, kGpuInfoPlaceholder, json);
+  return base::RefCountedString::TakeString(&page);
+}
+
+}  // namespace
+
 ResourceRequestJob::ResourceRequestJob(
     net::URLRequest* request,
     net::NetworkDelegate* network_delegate,
@@ -144,6 +172,10 @@ void ResourceRequestJob::StartAsync() {
     return;
 
   NotifyHeadersComplete();
+  if (resource_id_ == IDR_NW_GPU) {
+    DataAvailable(BuildGpuPage());
+    return;
+  }
   DataAvailable(ResourceBundle::GetSharedInstance().LoadDataResourceBytes(
       resource_id_));
 }
@@ -27,6 +27,7 @@
 #include "content/public/browser/browser_thread.h"
 #include "content/public/common/url_constants.h"
 #include "content/nw/src/net/shell_network_delegate.h"
+#include "content/nw/src/net/snapshot_persistent_cookie_store.h"
 #include "content/public/browser/cookie_store_factory.h"
 #include "content/nw/src/nw_protocol_handler.h"
 #include "content/nw/src/nw_shell.h"
@@ -77,11 +78,15 @@ ShellURLRequestContextGetter::ShellURLRequestContextGetter(
     const FilePath& base_path,
     MessageLoop* io_loop,
     MessageLoop* file_loop,
-    ProtocolHandlerMap* protocol_handlers)
+    ProtocolHandlerMap* protocol_handlers,
+    bool snapshot_cookies,
+    const base::TimeDelta& cookie_snapshot_interval)
     : ignore_certificate_errors_(ignore_certificate_errors),
       base_path_(base_path),
       io_loop_(io_loop),
-      file_loop_(file_loop) {
+      file_loop_(file_loop),
+      snapshot_cookies_(snapshot_cookies),
+      cookie_snapshot_interval_(cookie_snapshot_interval) {
   // Must first be created on the UI thread.
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
@@ -108,14 +113,23 @@ net::URLRequestContext* ShellURLRequestContextGetter::GetURLRequestContext() {
     storage_.reset(
         new net::URLRequestContextStorage(url_request_context_.get()));
 
-    FilePath cookie_path = base_path_.Append(FILE_PATH_LITERAL("cookies"));
     scoped_refptr<net::CookieStore> cookie_store = NULL;
-    cookie_store = content::CreatePersistentCookieStore(
-        cookie_path,
-        false,
-        NULL,
-        NULL);
-    cookie_store->GetCookieMonster()->SetPersistSessionCookies(true);
+    if (snapshot_cookies_) {
+      FilePath snapshot_path =
+          base_path_.Append(FILE_PATH_LITERAL("cookies.snapshot"));
+      cookie_store = new net::CookieMonster(
+          new SnapshotPersistentCookieStore(snapshot_path,
+                                            cookie_snapshot_interval_),
+          NULL);
+    } else {
+      FilePath cookie_path = base_path_.Append(FILE_PATH_LITERAL("cookies"));
+      cookie_store = content::CreatePersistentCookieStore(
+          cookie_path,
+          false,
+          NULL,
+          NULL);
+      cookie_store->GetCookieMonster()->SetPersistSessionCookies(true);
+    }
     storage_->set_cookie_store(cookie_store);
 
     storage_->set_server_bound_cert_service(new net::ServerBoundCertService(
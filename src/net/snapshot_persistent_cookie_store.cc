@@ -0,0 +1,236 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy 
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "content/nw/src/net/snapshot_persistent_cookie_store.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/message_loop.h"
+#include "base/metrics/histogram.h"
+#include "base/pickle.h"
+#include "content/public/browser/browser_thread.h"
+#include "googleurl/src/gurl.h"
+
+using base::Time;
+using content::BrowserThread;
+
+namespace {
+
+// Bump this when the layout written by SerializeData() changes; snapshots of
+// another version are ignored.
+const int kSnapshotVersion = 1;
+
+// Reads and parses the snapshot at |path| into |cookies|. Runs on the FILE
+// thread. A missing or malformed snapshot simply yields no cookies.
+void ReadSnapshotOnFileThread(const base::FilePath& path,
+                              std::vector<net::CanonicalCookie*>* cookies) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+
+  std::string data;
+  if (!file_util::ReadFileToString(path, &data))
+    return;
+
+  Pickle pickle(data.data(), data.size());
+  PickleIterator iter(pickle);
+  int version, count;
+  if (!iter.ReadInt(&version) || version != kSnapshotVersion ||
+      !iter.ReadInt(&count) || count < 0) {
+    LOG(WARNING) << "Ignoring unreadable cookie snapshot.";
+    return;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    std::string name, value, domain, path_value;
+    int64 creation, expiry, last_access;
+    bool secure, httponly;
+    if (!iter.ReadString(&name) || !iter.ReadString(&value) ||
+        !iter.ReadString(&domain) || !iter.ReadString(&path_value) ||
+        !iter.ReadInt64(&creation) || !iter.ReadInt64(&expiry) ||
+        !iter.ReadInt64(&last_access) || !iter.ReadBool(&secure) ||
+        !iter.ReadBool(&httponly)) {
+      LOG(WARNING) << "Cookie snapshot is truncated.";
+      break;
+    }
+    cookies->push_back(new net::CanonicalCookie(
+        // The "source" URL is not used with persisted cookies.
+        GURL(), name, value, domain, path_value,
+        Time::FromInternalValue(creation),
+        Time::FromInternalValue(expiry),
+        Time::FromInternalValue(last_access),
+        secure, httponly));
+  }
+
+  UMA_HISTOGRAM_TIMES("Cookie.TimeLoadSnapshot",
+                      base::TimeTicks::Now() - start_time);
+}
+
+}  // namespace
+
+SnapshotPersistentCookieStore::SnapshotPersistentCookieStore(
+    const base::FilePath& path,
+    const base::TimeDelta& snapshot_interval)
+    : path_(path),
+      writer_(path,
+              BrowserThread::GetMessageLoopProxyForThread(
+                  BrowserThread::FILE).get()),
+      loaded_(false) {
+  writer_.set_commit_interval(snapshot_interval);
+}
+
+SnapshotPersistentCookieStore::~SnapshotPersistentCookieStore() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  // Write out whatever changed since the last snapshot on clean shutdown.
+  if (writer_.HasPendingWrite())
+    writer_.DoScheduledWrite();
+}
+
+void SnapshotPersistentCookieStore::Load(
+    const LoadedCallback& loaded_callback) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  DCHECK(loaded_callback_.is_null());
+  loaded_callback_ = loaded_callback;
+
+  CookieVector* cookies = new CookieVector;
+  BrowserThread::PostTaskAndReply(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&ReadSnapshotOnFileThread, path_, cookies),
+      base::Bind(&SnapshotPersistentCookieStore::OnSnapshotLoaded, this,
+                 base::Owned(cookies)));
+}
+
+void SnapshotPersistentCookieStore::LoadCookiesForKey(
+    const std::string& key,
+    const LoadedCallback& loaded_callback) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  // The whole snapshot is read in one go, so there is nothing to prioritize:
+  // every cookie is handed over through the Load() callback.
+  if (loaded_) {
+    MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(loaded_callback, CookieVector()));
+    return;
+  }
+  pending_key_callbacks_.push_back(loaded_callback);
+}
+
+void SnapshotPersistentCookieStore::OnSnapshotLoaded(CookieVector* cookies) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  for (CookieVector::const_iterator it = cookies->begin();
+       it != cookies->end(); ++it) {
+    cookies_.insert(std::make_pair(
+        (*it)->CreationDate().ToInternalValue(), **it));
+  }
+  UMA_HISTOGRAM_COUNTS_10000("Cookie.NumberOfLoadedCookies", cookies->size());
+
+  loaded_ = true;
+
+  // |loaded_callback_| takes ownership of the cookies.
+  CookieVector loaded;
+  loaded.swap(*cookies);
+  loaded_callback_.Run(loaded);
+  loaded_callback_.Reset();
+
+  std::vector<LoadedCallback> key_callbacks;
+  key_callbacks.swap(pending_key_callbacks_);
+  for (size_t i = 0; i < key_callbacks.size(); ++i)
+    key_callbacks[i].Run(CookieVector());
+}
+
+void SnapshotPersistentCookieStore::StoreCookie(
+    const net::CanonicalCookie& cc) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  int64 creation = cc.CreationDate().ToInternalValue();
+  CookieMap::iterator it = cookies_.find(creation);
+  if (it != cookies_.end())
+    it->second = cc;
+  else
+    cookies_.insert(std::make_pair(creation, cc));
+  writer_.ScheduleWrite(this);
+}
+
+void SnapshotPersistentCookieStore::AddCookie(const net::CanonicalCookie& cc) {
+  StoreCookie(cc);
+}
+
+void SnapshotPersistentCookieStore::UpdateCookieAccessTime(
+    const net::CanonicalCookie& cc) {
+  StoreCookie(cc);
+}
+
+void SnapshotPersistentCookieStore::DeleteCookie(
+    const net::CanonicalCookie& cc) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (cookies_.erase(cc.CreationDate().ToInternalValue()))
+    writer_.ScheduleWrite(this);
+}
+
+void SnapshotPersistentCookieStore::SetForceKeepSessionState() {
+  // Session cookies are never written to the snapshot, so there is no
+  // session state to keep.
+}
+
+void SnapshotPersistentCookieStore::Flush(const base::Closure& callback) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (writer_.HasPendingWrite())
+    writer_.DoScheduledWrite();
+  if (!callback.is_null()) {
+    // Run the callback on the FILE thread after the write that was just
+    // posted there, matching the other stores' "flushed to disk" meaning.
+    BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE, callback);
+  }
+}
+
+bool SnapshotPersistentCookieStore::SerializeData(std::string* data) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  // Session cookies are not restored across runs, so only the persistent
+  // ones go into the snapshot.
+  int count = 0;
+  for (CookieMap::const_iterator it = cookies_.begin();
+       it != cookies_.end(); ++it) {
+    if (it->second.IsPersistent())
+      ++count;
+  }
+
+  Pickle pickle;
+  pickle.WriteInt(kSnapshotVersion);
+  pickle.WriteInt(count);
+  for (CookieMap::const_iterator it = cookies_.begin();
+       it != cookies_.end(); ++it) {
+    const net::CanonicalCookie& cc = it->second;
+    if (!cc.IsPersistent())
+      continue;
+    pickle.WriteString(cc.Name());
+    pickle.WriteString(cc.Value());
+    pickle.WriteString(cc.Domain());
+    pickle.WriteString(cc.Path());
+    pickle.WriteInt64(cc.CreationDate().ToInternalValue());
+    pickle.WriteInt64(cc.ExpiryDate().ToInternalValue());
+    pickle.WriteInt64(cc.LastAccessDate().ToInternalValue());
+    pickle.WriteBool(cc.IsSecure());
+    pickle.WriteBool(cc.IsHttpOnly());
+  }
+
+  data->assign(static_cast<const char*>(pickle.data()), pickle.size());
+  return true;
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2012 Intel Corp
+// Copyright (c) 2012 The Chromium Authors
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy 
+// of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell co
+// pies of the Software, and to permit persons to whom the Software is furnished
+//  to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in al
+// l copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM
+// PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNES
+// S FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//  OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WH
+// ETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+//  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef CONTENT_NW_SRC_NET_SNAPSHOT_PERSISTENT_COOKIE_STORE_H_
+#define CONTENT_NW_SRC_NET_SNAPSHOT_PERSISTENT_COOKIE_STORE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/time.h"
+#include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_monster.h"
+
+// Implements the PersistentCookieStore interface by keeping every cookie in
+// memory and periodically writing a compact snapshot of the persistent ones
+// to |path|. The snapshot is written atomically (temp file + rename) by
+// base::ImportantFileWriter, at most once per |snapshot_interval| and once
+// more when the store is destroyed, so a crash never leaves a torn file
+// behind. Loading is a single sequential read of the snapshot.
+//
+// Unlike SQLitePersistentCookieStore this avoids the small random writes of
+// the database, at the cost of losing changes made since the last snapshot
+// on a crash.
+//
+// All methods, including the destructor, must be called on the IO thread.
+class SnapshotPersistentCookieStore
+    : public net::CookieMonster::PersistentCookieStore,
+      public base::ImportantFileWriter::DataSerializer {
+ public:
+  SnapshotPersistentCookieStore(const base::FilePath& path,
+                                const base::TimeDelta& snapshot_interval);
+
+  // net::CookieMonster::PersistentCookieStore:
+  virtual void Load(const LoadedCallback& loaded_callback) OVERRIDE;
+  virtual void LoadCookiesForKey(const std::string& key,
+      const LoadedCallback& callback) OVERRIDE;
+  virtual void AddCookie(const net::CanonicalCookie& cc) OVERRIDE;
+  virtual void UpdateCookieAccessTime(const net::CanonicalCookie& cc) OVERRIDE;
+  virtual void DeleteCookie(const net::CanonicalCookie& cc) OVERRIDE;
+  virtual void SetForceKeepSessionState() OVERRIDE;
+  virtual void Flush(const base::Closure& callback) OVERRIDE;
+
+  // base::ImportantFileWriter::DataSerializer:
+  virtual bool SerializeData(std::string* data) OVERRIDE;
+
+ protected:
+  virtual ~SnapshotPersistentCookieStore();
+
+ private:
+  typedef std::vector<net::CanonicalCookie*> CookieVector;
+
+  // Called on the IO thread once the snapshot has been read on the FILE
+  // thread; takes ownership of the cookies in |cookies|.
+  void OnSnapshotLoaded(CookieVector* cookies);
+
+  // Replaces or inserts |cc| and schedules a snapshot.
+  void StoreCookie(const net::CanonicalCookie& cc);
+
+  // Cookies keyed by creation time, which CookieMonster keeps unique.
+  typedef std::map<int64, net::CanonicalCookie> CookieMap;
+  CookieMap cookies_;
+
+  base::FilePath path_;
+  base::ImportantFileWriter writer_;
+
+  bool loaded_;
+  LoadedCallback loaded_callback_;
+
+  // Priority loads requested before the snapshot has been read. They are
+  // answered after |loaded_callback_| has delivered every cookie.
+  std::vector<LoadedCallback> pending_key_callbacks_;
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotPersistentCookieStore);
+};
+
+#endif  // CONTENT_NW_SRC_NET_SNAPSHOT_PERSISTENT_COOKIE_STORE_H_
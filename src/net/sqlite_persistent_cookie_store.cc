@@ -646,8 +646,13 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
       BrowserThread::IO, FROM_HERE,
       base::Bind(&SQLitePersistentCookieStore::Backend::CompleteLoadOnIOThread,
                  this, loaded_callback, load_success));
-    if (load_success && !restore_old_session_cookies_)
-      DeleteSessionCookiesOnStartup();
+    // The session cookies are already filtered out of what was loaded, so
+    // removing them from the DB does not need to delay the notification.
+    if (load_success && !restore_old_session_cookies_) {
+      BrowserThread::PostTask(
+        BrowserThread::DB, FROM_HERE,
+        base::Bind(&Backend::DeleteSessionCookiesOnStartup, this));
+    }
   }
 }
 
@@ -1000,9 +1005,22 @@ void SQLitePersistentCookieStore::Backend::DeleteSessionCookiesOnShutdown() {
   if (!db_.get())
     return;
 
-  sql::Statement del_smt(db_->GetCachedStatement(
-      SQL_FROM_HERE, "DELETE FROM cookies WHERE host_key=? AND secure=?"));
-  if (!del_smt.is_valid()) {
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+
+  // Collect the origins to clear into a temporary table and remove all their
+  // cookies with a single statement, instead of running one DELETE per origin.
+  if (!db_->Execute("CREATE TEMP TABLE IF NOT EXISTS clear_on_exit_origins ("
+                    "host_key TEXT NOT NULL,"
+                    "secure INTEGER NOT NULL,"
+                    "PRIMARY KEY (host_key, secure))")) {
+    LOG(WARNING) << "Unable to delete cookies on shutdown.";
+    return;
+  }
+
+  sql::Statement add_smt(db_->GetUniqueStatement(
+      "INSERT OR IGNORE INTO temp.clear_on_exit_origins (host_key, secure) "
+      "VALUES (?,?)"));
+  if (!add_smt.is_valid()) {
     LOG(WARNING) << "Unable to delete cookies on shutdown.";
     return;
   }
@@ -1013,6 +1031,7 @@ void SQLitePersistentCookieStore::Backend::DeleteSessionCookiesOnShutdown() {
     return;
   }
 
+  int num_origins = 0;
   for (CookiesPerOriginMap::iterator it = cookies_per_origin_.begin();
        it != cookies_per_origin_.end(); ++it) {
     if (it->second <= 0) {
@@ -1024,15 +1043,31 @@ void SQLitePersistentCookieStore::Backend::DeleteSessionCookiesOnShutdown() {
       continue;
     }
 
-    del_smt.Reset(true);
-    del_smt.BindString(0, it->first.first);
-    del_smt.BindInt(1, it->first.second);
-    if (!del_smt.Run())
-      NOTREACHED() << "Could not delete a cookie from the DB.";
+    add_smt.Reset(true);
+    add_smt.BindString(0, it->first.first);
+    add_smt.BindInt(1, it->first.second);
+    if (!add_smt.Run())
+      NOTREACHED() << "Could not record an origin to clear on exit.";
+    ++num_origins;
   }
 
+  if (num_origins > 0 &&
+      !db_->Execute("DELETE FROM cookies WHERE EXISTS ("
+                    "SELECT 1 FROM temp.clear_on_exit_origins o "
+                    "WHERE o.host_key = cookies.host_key "
+                    "AND o.secure = cookies.secure)")) {
+    NOTREACHED() << "Could not delete cookies from the DB.";
+  }
+
+  ignore_result(db_->Execute("DROP TABLE temp.clear_on_exit_origins"));
+
   if (!transaction.Commit())
     LOG(WARNING) << "Unable to delete cookies on shutdown.";
+
+  UMA_HISTOGRAM_COUNTS_10000("Cookie.NumberOfOriginsClearedOnExit",
+                             num_origins);
+  UMA_HISTOGRAM_TIMES("Cookie.TimeDeleteSessionCookiesOnShutdown",
+                      base::TimeTicks::Now() - start_time);
 }
 
 void SQLitePersistentCookieStore::Backend::ScheduleKillDatabase() {
@@ -1067,8 +1102,16 @@ void SQLitePersistentCookieStore::Backend::SetForceKeepSessionState() {
 
 void SQLitePersistentCookieStore::Backend::DeleteSessionCookiesOnStartup() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
-  if (!db_->Execute("DELETE FROM cookies WHERE persistent == 0"))
+
+  // Maybe we are already Close()'ed.
+  if (!db_.get())
+    return;
+
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+  if (!db_->Execute("DELETE FROM cookies WHERE persistent = 0"))
     LOG(WARNING) << "Unable to delete session cookies.";
+  UMA_HISTOGRAM_TIMES("Cookie.TimeDeleteSessionCookiesOnStartup",
+                      base::TimeTicks::Now() - start_time);
 }
 
 SQLitePersistentCookieStore::SQLitePersistentCookieStore(
@@ -20,6 +20,7 @@
 
 #include "content/nw/src/nw_package.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "base/command_line.h"
@@ -29,8 +30,10 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_tokenizer.h"
 #include "base/string_util.h"
+#include "base/sys_info.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/values.h"
+#include "cc/switches.h"
 #include "third_party/zlib/google/zip.h"
 #include "content/nw/src/common/shell_switches.h"
 #include "content/public/common/content_switches.h"
@@ -53,6 +56,9 @@ namespace nw {
 // Separator for string of |chromium_args| from |manifest|.
 const char kChromiumArgsSeparator[] = " ";
 
+// Upper bound of the "threads" field of "raster".
+const int kMaxRasterThreads = 16;
+
 namespace {
 
 #ifndef PATH_MAX
@@ -314,6 +320,18 @@ bool Package::InitFromPath() {
   // Read chromium command line args.
   ReadChromiumArgs();
 
+  ReadRasterSettings();
+
+  bool headless = false;
+  CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (root_->GetBoolean(switches::kmHeadless, &headless) && headless)
+    command_line->AppendSwitch(switches::kHeadless);
+  if (command_line->HasSwitch(switches::kHeadless)) {
+    // Headless servers usually have no GPU; keep everything in software.
+    command_line->AppendSwitch(switches::kDisableGpu);
+    command_line->AppendSwitch(switches::kDisableAcceleratedCompositing);
+  }
+
   // Read flags for v8 engine.
   ReadJsFlags();
 
@@ -439,6 +457,34 @@ void Package::ReadJsFlags() {
   command_line->AppendSwitchASCII("js-flags", flags);
 }
 
+void Package::ReadRasterSettings() {
+  base::DictionaryValue* raster;
+  if (!root()->GetDictionary(switches::kmRaster, &raster))
+    return;
+
+  bool impl_side_painting = false;
+  raster->GetBoolean(switches::kmImplSidePainting, &impl_side_painting);
+  if (!impl_side_painting)
+    return;
+
+  int threads = 0;
+  if (!raster->GetInteger(switches::kmRasterThreads, &threads) ||
+      threads <= 0) {
+    // Leave one core to the renderer main thread.
+    threads = base::SysInfo::NumberOfProcessors() - 1;
+  }
+  threads = std::max(1, std::min(threads, kMaxRasterThreads));
+
+  // Raster threads belong to the threaded compositor, so impl-side painting
+  // needs it forced on for every page.
+  CommandLine* command_line = CommandLine::ForCurrentProcess();
+  command_line->AppendSwitch(switches::kEnableThreadedCompositing);
+  command_line->AppendSwitch(switches::kForceCompositingMode);
+  command_line->AppendSwitch(cc::switches::kEnableImplSidePainting);
+  command_line->AppendSwitchASCII(cc::switches::kNumRasterThreads,
+                                  base::IntToString(threads));
+}
+
 void Package::ReportError(const std::string& title,
                           const std::string& content) {
   if (!error_page_url_.empty())
@@ -90,6 +90,9 @@ class Package {
   // Read js flags from the package.json if specifed.
   void ReadJsFlags();
 
+  // Turn the "raster" field of the package.json into compositor switches.
+  void ReadRasterSettings();
+
   // Convert error info into data url.
   void ReportError(const std::string& title, const std::string& content);
 
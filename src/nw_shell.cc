@@ -44,9 +44,12 @@
 #include "content/nw/src/api/api_messages.h"
 #include "content/nw/src/api/app/app.h"
 #include "content/nw/src/browser/file_select_helper.h"
+#include "content/nw/src/browser/first_paint_tracker.h"
 #include "content/nw/src/browser/native_window.h"
 #include "content/nw/src/browser/shell_devtools_delegate.h"
 #include "content/nw/src/browser/shell_javascript_dialog_creator.h"
+#include "content/nw/src/browser/window_discarder.h"
+#include "content/nw/src/browser/window_throttler.h"
 #include "content/nw/src/common/shell_switches.h"
 #include "content/nw/src/media/media_stream_devices_controller.h"
 #include "content/nw/src/nw_package.h"
@@ -57,6 +60,7 @@
 #include "net/base/escape.h"
 #include "ui/base/resource/resource_bundle.h"
 
+#include "content/nw/src/browser/printing/print_preview_message_handler.h"
 #include "content/nw/src/browser/printing/print_view_manager.h"
 
 namespace content {
@@ -142,11 +146,16 @@ Shell::Shell(WebContents* web_contents, base::DictionaryValue* manifest)
   content::WebContentsObserver::Observe(web_contents);
   web_contents_->SetDelegate(this);
 
+  window_throttler_.reset(new nw::WindowThrottler(web_contents, manifest));
+  window_discarder_.reset(new nw::WindowDiscarder(this, manifest));
+  first_paint_tracker_.reset(new nw::FirstPaintTracker(this, manifest));
+
   // Create window.
   window_.reset(nw::NativeWindow::Create(this, manifest));
 
 #if defined(ENABLE_PRINTING)
   printing::PrintViewManager::CreateForWebContents(web_contents);
+  printing::PrintPreviewMessageHandler::CreateForWebContents(web_contents);
 #endif
 
   // Initialize window after we set window_, because some operations of
@@ -173,17 +182,19 @@ Shell::~Shell() {
 }
 
 void Shell::SendEvent(const std::string& event, const std::string& arg1) {
+  base::ListValue args;
+  if (!arg1.empty())
+    args.AppendString(arg1);
+  SendEvent(event, args);
+}
 
+void Shell::SendEvent(const std::string& event, const base::ListValue& args) {
   if (id() < 0)
     return;
 
   DVLOG(1) << "Shell::SendEvent " << event << " id():"
            << id() << " RoutingID: " << web_contents()->GetRoutingID();
 
-  base::ListValue args;
-  if (!arg1.empty())
-    args.AppendString(arg1);
-
   web_contents()->GetRenderViewHost()->Send(new ShellViewMsg_Object_On_Event(
       web_contents()->GetRoutingID(), id(), event, args));
 }
@@ -35,6 +35,7 @@
 namespace base {
 class DictionaryValue;
 class FilePath;
+class ListValue;
 }
 
 namespace extensions {
@@ -44,8 +45,11 @@ struct DraggableRegion;
 class GURL;
 
 namespace nw {
+class FirstPaintTracker;
 class NativeWindow;
 class Package;
+class WindowDiscarder;
+class WindowThrottler;
 }
 
 namespace content {
@@ -103,6 +107,7 @@ class Shell : public WebContentsDelegate,
 #endif
   // Send an event to renderer.
   void SendEvent(const std::string& event, const std::string& arg1 = "");
+  void SendEvent(const std::string& event, const base::ListValue& args);
 
   // Decide whether we should close the window.
   bool ShouldCloseWindow();
@@ -122,6 +127,11 @@ class Shell : public WebContentsDelegate,
 
   WebContents* web_contents() const { return web_contents_.get(); }
   nw::NativeWindow* window() { return window_.get(); }
+  nw::WindowThrottler* window_throttler() { return window_throttler_.get(); }
+  nw::WindowDiscarder* window_discarder() { return window_discarder_.get(); }
+  nw::FirstPaintTracker* first_paint_tracker() {
+    return first_paint_tracker_.get();
+  }
 
   void set_force_close(bool force) { force_close_ = force; }
   bool is_devtools() const { return is_devtools_; }
@@ -184,6 +194,10 @@ class Shell : public WebContentsDelegate,
 
   scoped_ptr<ShellJavaScriptDialogCreator> dialog_creator_;
   scoped_ptr<WebContents> web_contents_;
+  // Declared before |window_| so it outlives the native window's events.
+  scoped_ptr<nw::WindowThrottler> window_throttler_;
+  scoped_ptr<nw::WindowDiscarder> window_discarder_;
+  scoped_ptr<nw::FirstPaintTracker> first_paint_tracker_;
   scoped_ptr<nw::NativeWindow> window_;
 
   // Notification manager.
@@ -20,6 +20,8 @@
 
 #include "content/public/common/common_param_traits.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/size.h"
 
 // Singly-included section
 #ifndef CONTENT_NW_SRC_RENDERER_COMMON_RENDER_MESSAGES_H_
@@ -35,6 +37,28 @@ class SkBitmap;
 // render view responds with a ShellViewHostMsg_Snapshot.
 IPC_MESSAGE_ROUTED0(NwViewMsg_CaptureSnapshot)
 
+// Delays requestAnimationFrame callbacks of the page so they run at most
+// |fps| times a second. 0 removes the cap.
+IPC_MESSAGE_ROUTED1(NwViewMsg_SetMaxFrameRate,
+                    int /* fps */)
+
 // Send a snapshot of the tab contents to the render host.
 IPC_MESSAGE_ROUTED1(NwViewHostMsg_Snapshot,
                     SkBitmap /* bitmap */)
+
+// Tells the render view to paint the whole scrollable page in horizontal
+// tiles at most |tile height| pixels high. The render view answers with one
+// NwViewHostMsg_SnapshotTile per tile, top to bottom, all painted in one
+// layout of the page.
+IPC_MESSAGE_ROUTED2(NwViewMsg_CaptureFullPage,
+                    int /* request id */,
+                    int /* tile height */)
+
+// One tile of a full page capture. |tile rect| is in page coordinates; the
+// last tile reaches the bottom of |page size|. An empty bitmap and page
+// size mean the capture failed.
+IPC_MESSAGE_ROUTED4(NwViewHostMsg_SnapshotTile,
+                    int /* request id */,
+                    gfx::Rect /* tile rect */,
+                    gfx::Size /* page size */,
+                    SkBitmap /* tile */)
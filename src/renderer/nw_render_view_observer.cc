@@ -20,13 +20,20 @@
 
 #include "content/nw/src/renderer/nw_render_view_observer.h"
 
+#include <algorithm>
+
 #include "content/nw/src/renderer/common/render_messages.h"
 #include "content/public/renderer/render_view.h"
 #include "skia/ext/platform_canvas.h"
 #include "third_party/WebKit/Source/Platform/chromium/public/WebRect.h"
 #include "third_party/WebKit/Source/Platform/chromium/public/WebSize.h"
+#include "third_party/WebKit/Source/Platform/chromium/public/WebString.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebFrame.h"
+#include "third_party/WebKit/Source/WebKit/chromium/public/WebScriptSource.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebView.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/size.h"
+#include "v8/include/v8.h"
 #include "webkit/glue/webkit_glue.h"
 
 using WebKit::WebFrame;
@@ -35,8 +42,63 @@ using WebKit::WebSize;
 
 namespace nw {
 
+namespace {
+
+// Key of the hidden value of the global object that holds the function
+// changing the cap of the current document.
+const char kMaxFrameRateSetterKey[] = "nwSetMaxFrameRate";
+
+// Replaces requestAnimationFrame with a version that holds back the request
+// for the next frame until the interval has passed since the last one, less
+// a few ms so the next vsync is not missed. Evaluates to the function that
+// sets the cap in fps, 0 meaning none. Its state lives in the closure, so
+// the page sees nothing but the wrapped functions.
+const char kMaxFrameRateScript[] =
+    "(function() {"
+    "  var interval = 0, last = 0;"
+    "  var raf = window.webkitRequestAnimationFrame;"
+    "  var caf = window.webkitCancelAnimationFrame;"
+    "  var nextId = 1, pending = {};"
+    "  var request = function(callback) {"
+    "    var id = nextId++;"
+    "    var ask = function() {"
+    "      pending[id] = { frame: raf.call(window, function(time) {"
+    "        delete pending[id];"
+    "        last = Date.now();"
+    "        callback(time);"
+    "      }) };"
+    "    };"
+    "    var wait = interval ? last + interval - 4 - Date.now() : 0;"
+    "    if (wait > 0)"
+    "      pending[id] = { timer: setTimeout(ask, wait) };"
+    "    else"
+    "      ask();"
+    "    return id;"
+    "  };"
+    "  var cancel = function(id) {"
+    "    var entry = pending[id];"
+    "    if (!entry)"
+    "      return;"
+    "    if (entry.timer)"
+    "      clearTimeout(entry.timer);"
+    "    else"
+    "      caf.call(window, entry.frame);"
+    "    delete pending[id];"
+    "  };"
+    "  window.requestAnimationFrame = window.webkitRequestAnimationFrame ="
+    "      request;"
+    "  window.cancelAnimationFrame = window.webkitCancelAnimationFrame ="
+    "      window.webkitCancelRequestAnimationFrame = cancel;"
+    "  return function(fps) {"
+    "    interval = fps > 0 ? 1000 / fps : 0;"
+    "  };"
+    "})()";
+
+}  // namespace
+
 NwRenderViewObserver::NwRenderViewObserver(content::RenderView* render_view) 
-    : content::RenderViewObserver(render_view) {
+    : content::RenderViewObserver(render_view),
+      max_fps_(0) {
 }
 
 NwRenderViewObserver::~NwRenderViewObserver() {
@@ -46,12 +108,53 @@ bool NwRenderViewObserver::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(NwRenderViewObserver, message)
     IPC_MESSAGE_HANDLER(NwViewMsg_CaptureSnapshot, OnCaptureSnapshot)
+    IPC_MESSAGE_HANDLER(NwViewMsg_CaptureFullPage, OnCaptureFullPage)
+    IPC_MESSAGE_HANDLER(NwViewMsg_SetMaxFrameRate, OnSetMaxFrameRate)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
   return handled;
 }
 
+void NwRenderViewObserver::DidClearWindowObject(WebFrame* frame) {
+  // Every new document of the main frame needs the wrapper again.
+  if (max_fps_ > 0 && frame == render_view()->GetWebView()->mainFrame())
+    ApplyMaxFrameRate(frame);
+}
+
+void NwRenderViewObserver::OnSetMaxFrameRate(int fps) {
+  max_fps_ = std::max(fps, 0);
+  WebFrame* main_frame = render_view()->GetWebView()->mainFrame();
+  if (main_frame)
+    ApplyMaxFrameRate(main_frame);
+}
+
+void NwRenderViewObserver::ApplyMaxFrameRate(WebFrame* frame) {
+  v8::HandleScope handle_scope;
+  v8::Handle<v8::Context> context = frame->mainWorldScriptContext();
+  if (context.IsEmpty())
+    return;
+  v8::Context::Scope context_scope(context);
+
+  // The wrapper is only installed once a cap is asked for, then kept for
+  // the life of the document; lifting the cap just sets it to 0.
+  v8::Handle<v8::Object> global = context->Global();
+  v8::Handle<v8::String> key = v8::String::New(kMaxFrameRateSetterKey);
+  v8::Handle<v8::Value> setter = global->GetHiddenValue(key);
+  if (setter.IsEmpty() || !setter->IsFunction()) {
+    if (max_fps_ == 0)
+      return;
+    setter = frame->executeScriptAndReturnValue(WebKit::WebScriptSource(
+        WebKit::WebString::fromUTF8(kMaxFrameRateScript)));
+    if (setter.IsEmpty() || !setter->IsFunction())
+      return;
+    global->SetHiddenValue(key, setter);
+  }
+
+  v8::Handle<v8::Value> argv[] = { v8::Integer::New(max_fps_) };
+  v8::Handle<v8::Function>::Cast(setter)->Call(global, 1, argv);
+}
+
 void NwRenderViewObserver::OnCaptureSnapshot() {
   SkBitmap snapshot;
   bool error = false;
@@ -70,26 +173,73 @@ void NwRenderViewObserver::OnCaptureSnapshot() {
   Send(new NwViewHostMsg_Snapshot(routing_id(), snapshot));
 }
 
+void NwRenderViewObserver::OnCaptureFullPage(int request_id,
+                                             int tile_height) {
+  WebKit::WebView* view = render_view()->GetWebView();
+  WebFrame* main_frame = view ? view->mainFrame() : NULL;
+  if (!main_frame || tile_height <= 0) {
+    Send(new NwViewHostMsg_SnapshotTile(routing_id(), request_id,
+                                        gfx::Rect(), gfx::Size(), SkBitmap()));
+    return;
+  }
+
+  view->layout();
+  const WebSize old_size = view->size();
+  const WebSize contents_size = main_frame->contentsSize();
+  const WebSize scroll_offset = main_frame->scrollOffset();
+  const gfx::Size page_size(
+      old_size.width, std::max(old_size.height, contents_size.height));
+
+  // Growing the view to the document lays everything out once so every
+  // tile can be painted; it also resets the scroll offset. Both are
+  // restored before anything else runs, so scripts, including the resize
+  // handlers WebKit queues, only ever see the page at its own size. Each
+  // tile is sent as soon as it is painted, so only one is ever held here.
+  view->resize(WebSize(page_size.width(), page_size.height()));
+  view->layout();
+  for (int y = 0; y < page_size.height(); y += tile_height) {
+    gfx::Rect rect(0, y, page_size.width(),
+                   std::min(tile_height, page_size.height() - y));
+    SkBitmap tile;
+    if (!PaintTile(view, rect, &tile)) {
+      Send(new NwViewHostMsg_SnapshotTile(routing_id(), request_id,
+                                          gfx::Rect(), gfx::Size(),
+                                          SkBitmap()));
+      break;
+    }
+    Send(new NwViewHostMsg_SnapshotTile(routing_id(), request_id, rect,
+                                        page_size, tile));
+  }
+  view->resize(old_size);
+  view->layout();
+  main_frame->setScrollOffset(scroll_offset);
+}
+
 bool NwRenderViewObserver::CaptureSnapshot(WebKit::WebView* view,
                                            SkBitmap* snapshot) {
   view->layout();
   const WebSize& size = view->size();
+  return PaintTile(view, gfx::Rect(0, 0, size.width, size.height), snapshot);
+}
 
+bool NwRenderViewObserver::PaintTile(WebKit::WebView* view,
+                                     const gfx::Rect& rect,
+                                     SkBitmap* tile) {
   skia::RefPtr<SkCanvas> canvas = skia::AdoptRef(
       skia::CreatePlatformCanvas(
-          size.width, size.height, true, NULL, skia::RETURN_NULL_ON_FAILURE));
+          rect.width(), rect.height(), true, NULL,
+          skia::RETURN_NULL_ON_FAILURE));
   if (!canvas)
     return false;
 
+  canvas->translate(SkIntToScalar(-rect.x()), SkIntToScalar(-rect.y()));
   view->paint(webkit_glue::ToWebCanvas(canvas.get()),
-              WebRect(0, 0, size.width, size.height));
-  // TODO: Add a way to snapshot the whole page, not just the currently
-  // visible part.
+              WebRect(rect.x(), rect.y(), rect.width(), rect.height()));
 
   SkDevice* device = skia::GetTopDevice(*canvas);
 
   const SkBitmap& bitmap = device->accessBitmap(false);
-  if (!bitmap.copyTo(snapshot, SkBitmap::kARGB_8888_Config))
+  if (!bitmap.copyTo(tile, SkBitmap::kARGB_8888_Config))
     return false;
 
   return true;
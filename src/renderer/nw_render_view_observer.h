@@ -25,7 +25,12 @@
 
 class SkBitmap;
 
+namespace gfx {
+class Rect;
+}
+
 namespace WebKit {
+class WebFrame;
 class WebView;
 }
 
@@ -40,12 +45,26 @@ class NwRenderViewObserver : public content::RenderViewObserver {
   // RenderViewObserver implementation.
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
 
+  virtual void DidClearWindowObject(WebKit::WebFrame* frame) OVERRIDE;
+
   void OnCaptureSnapshot();
+  void OnCaptureFullPage(int request_id, int tile_height);
+  void OnSetMaxFrameRate(int fps);
+
+  // Sets the requestAnimationFrame cap of |frame| to |max_fps_|, wrapping
+  // requestAnimationFrame the first time a cap is set in the document.
+  void ApplyMaxFrameRate(WebKit::WebFrame* frame);
 
   // Capture a snapshot of a view.  This is used to allow an extension
   // to get a snapshot of a tab using chrome.tabs.captureVisibleTab().
   bool CaptureSnapshot(WebKit::WebView* view, SkBitmap* snapshot);
 
+  // Paints |rect| of |view|, in view coordinates, into |tile|.
+  bool PaintTile(WebKit::WebView* view, const gfx::Rect& rect, SkBitmap* tile);
+
+  // Cap on requestAnimationFrame callbacks a second, 0 for none.
+  int max_fps_;
+
   DISALLOW_COPY_AND_ASSIGN(NwRenderViewObserver);
 };
 
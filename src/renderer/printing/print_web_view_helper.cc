@@ -399,7 +399,6 @@ bool IsPrintThrottlingDisabled() {
 
 }  // namespace
 
-// static - Not anonymous so that platform implementations can use it.
 void PrintWebViewHelper::PrintHeaderAndFooter(
     WebKit::WebCanvas* canvas,
     int page_number,
@@ -420,18 +419,22 @@ void PrintWebViewHelper::PrintHeaderAndFooter(
                             page_layout.margin_top + page_layout.margin_bottom +
                             page_layout.content_height);
 
-  WebKit::WebView* web_view = WebKit::WebView::create(NULL);
-  web_view->settings()->setJavaScriptEnabled(true);
-  web_view->initializeMainFrame(NULL);
+  if (!header_footer_view_) {
+    header_footer_view_ = WebKit::WebView::create(NULL);
+    header_footer_view_->settings()->setJavaScriptEnabled(true);
+    header_footer_view_->initializeMainFrame(NULL);
 
-  WebKit::WebFrame* frame = web_view->mainFrame();
+    base::StringValue html(
+        ResourceBundle::GetSharedInstance().GetLocalizedString(
+            IDR_PRINT_PREVIEW_PAGE));
+    // Load page with script to avoid async operations.
+    ExecuteScript(header_footer_view_->mainFrame(), kPageLoadScriptFormat,
+                  html);
+  }
 
-  base::StringValue html(
-      ResourceBundle::GetSharedInstance().GetLocalizedString(
-          IDR_PRINT_PREVIEW_PAGE));
-  // Load page with script to avoid async operations.
-  ExecuteScript(frame, kPageLoadScriptFormat, html);
+  WebKit::WebFrame* frame = header_footer_view_->mainFrame();
 
+  // Only the page number and the page layout change from page to page.
   scoped_ptr<base::DictionaryValue> options(header_footer_info.DeepCopy());
   options->SetDouble("width", page_size.width);
   options->SetDouble("height", page_size.height);
@@ -449,11 +452,16 @@ void PrintWebViewHelper::PrintHeaderAndFooter(
   frame->printPage(0, canvas);
   frame->printEnd();
 
-  web_view->close();
-
   device->setDrawingArea(SkPDFDevice::kContent_DrawingArea);
 }
 
+void PrintWebViewHelper::CloseHeaderAndFooterView() {
+  if (!header_footer_view_)
+    return;
+  header_footer_view_->close();
+  header_footer_view_ = NULL;
+}
+
 // static - Not anonymous so that platform implementations can use it.
 float PrintWebViewHelper::RenderPageContent(WebKit::WebFrame* frame,
                                             int page_number,
@@ -708,10 +716,13 @@ PrintWebViewHelper::PrintWebViewHelper(content::RenderView* render_view)
       is_scripted_printing_blocked_(false),
       notify_browser_of_print_failure_(true),
       print_for_preview_(false),
+      header_footer_view_(NULL),
       print_node_in_progress_(false) {
 }
 
-PrintWebViewHelper::~PrintWebViewHelper() {}
+PrintWebViewHelper::~PrintWebViewHelper() {
+  CloseHeaderAndFooterView();
+}
 
 bool PrintWebViewHelper::IsScriptInitiatedPrintAllowed(
     WebKit::WebFrame* frame, bool user_initiated) {
@@ -754,6 +765,7 @@ bool PrintWebViewHelper::OnMessageReceived(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(PrintMsg_PrintNodeUnderContextMenu,
                         OnPrintNodeUnderContextMenu)
     IPC_MESSAGE_HANDLER(PrintMsg_PrintPreview, OnPrintPreview)
+    IPC_MESSAGE_HANDLER(PrintMsg_PrintToPDF, OnPrintToPDF)
     IPC_MESSAGE_HANDLER(PrintMsg_PrintForPrintPreview, OnPrintForPrintPreview)
     IPC_MESSAGE_HANDLER(PrintMsg_PrintingDone, OnPrintingDone)
     IPC_MESSAGE_HANDLER(PrintMsg_ResetScriptedPrintCount,
@@ -903,7 +915,7 @@ WebKit::WebPrintScalingOption PrintWebViewHelper::GetPrintScalingOption(
 }
 
 void PrintWebViewHelper::OnPrintPreview(const DictionaryValue& settings) {
-  DCHECK(is_preview_enabled_);
+  // Also reached from OnPrintToPDF(), which works without print preview.
   print_preview_context_.OnPrintPreview();
 
   if (!UpdatePrintSettings(print_preview_context_.source_frame(),
@@ -963,6 +975,18 @@ void PrintWebViewHelper::OnPrintPreview(const DictionaryValue& settings) {
   PrepareFrameForPreviewDocument();
 }
 
+void PrintWebViewHelper::OnPrintToPDF(const DictionaryValue& settings) {
+  // Run the preview pipeline on the main frame without the preview UI; the
+  // PDF goes back in PrintHostMsg_MetafileReadyForPrinting.
+  if (print_preview_context_.IsRendering()) {
+    Send(new PrintHostMsg_PrintPreviewFailed(routing_id(), 0));
+    return;
+  }
+  print_preview_context_.InitWithFrame(
+      render_view()->GetWebView()->mainFrame());
+  OnPrintPreview(settings);
+}
+
 void PrintWebViewHelper::PrepareFrameForPreviewDocument() {
   reset_prep_frame_view_ = false;
 
@@ -1077,6 +1101,7 @@ bool PrintWebViewHelper::CreatePreviewDocument() {
 
 bool PrintWebViewHelper::FinalizePrintReadyDocument() {
   DCHECK(!is_print_ready_metafile_sent_);
+  base::TimeTicks begin_time = base::TimeTicks::Now();
   print_preview_context_.FinalizePrintReadyDocument();
 
   // Get the size of the resulting metafile.
@@ -1103,11 +1128,20 @@ bool PrintWebViewHelper::FinalizePrintReadyDocument() {
   }
   is_print_ready_metafile_sent_ = true;
 
+  preview_params.layout_time = print_preview_context_.layout_time();
+  preview_params.render_time = print_preview_context_.document_render_time();
+  preview_params.finalize_time = base::TimeTicks::Now() - begin_time;
+
   Send(new PrintHostMsg_MetafileReadyForPrinting(routing_id(), preview_params));
   return true;
 }
 
-void PrintWebViewHelper::OnPrintingDone(bool success) {
+void PrintWebViewHelper::OnPrintingDone(int document_cookie, bool success) {
+  // A job the browser let finish in the background reports in after a newer
+  // print has started; that one must be left alone.
+  if (print_pages_params_.get() &&
+      print_pages_params_->params.document_cookie != document_cookie)
+    return;
   notify_browser_of_print_failure_ = false;
   if (!success)
     LOG(ERROR) << "Failure in OnPrintingDone";
@@ -1218,7 +1252,6 @@ void PrintWebViewHelper::DidFinishPrinting(PrintingResult result) {
       break;
 
     case FAIL_PREVIEW:
-      DCHECK(is_preview_enabled_);
       store_print_pages_params = false;
       int cookie = print_pages_params_.get() ?
           print_pages_params_->params.document_cookie : 0;
@@ -1233,6 +1266,7 @@ void PrintWebViewHelper::DidFinishPrinting(PrintingResult result) {
   }
 
   prep_frame_view_.reset();
+  CloseHeaderAndFooterView();
 
   if (store_print_pages_params) {
     old_print_pages_params_.reset(print_pages_params_.release());
@@ -1391,7 +1425,6 @@ bool PrintWebViewHelper::UpdatePrintSettings(
     WebKit::WebFrame* frame,
     const WebKit::WebNode& node,
     const DictionaryValue& passed_job_settings) {
-  DCHECK(is_preview_enabled_);
   const DictionaryValue* job_settings = &passed_job_settings;
   DictionaryValue modified_job_settings;
   if (job_settings->empty()) {
@@ -1740,9 +1773,11 @@ bool PrintWebViewHelper::PrintPreviewContext::CreatePreviewDocument(
 
   // Need to make sure old object gets destroyed first.
   prep_frame_view_.reset(prepared_frame);
+  base::TimeTicks layout_begin_time = base::TimeTicks::Now();
   prep_frame_view_->StartPrinting();
 
   total_page_count_ = prep_frame_view_->GetExpectedPageCount();
+  layout_time_ = base::TimeTicks::Now() - layout_begin_time;
   if (total_page_count_ == 0) {
     LOG(ERROR) << "CreatePreviewDocument got 0 page count";
     set_error(PREVIEW_ERROR_ZERO_PAGES);
@@ -1925,6 +1960,16 @@ PreviewMetafile* PrintWebViewHelper::PrintPreviewContext::metafile() {
   return metafile_.get();
 }
 
+base::TimeDelta
+PrintWebViewHelper::PrintPreviewContext::layout_time() const {
+  return layout_time_;
+}
+
+base::TimeDelta
+PrintWebViewHelper::PrintPreviewContext::document_render_time() const {
+  return document_render_time_;
+}
+
 int PrintWebViewHelper::PrintPreviewContext::last_error() const {
   return error_;
 }
@@ -139,6 +139,9 @@ class PrintWebViewHelper
   // Start the process of generating a print preview using |settings|.
   void OnPrintPreview(const base::DictionaryValue& settings);
 
+  // Render the main frame into a PDF using |settings|, without print preview.
+  void OnPrintToPDF(const base::DictionaryValue& settings);
+
   // Prepare frame for creating preview document.
   void PrepareFrameForPreviewDocument();
 
@@ -163,7 +166,7 @@ class PrintWebViewHelper
   // for user settings. |job_settings| has new print job settings values.
   void OnPrintForPrintPreview(const base::DictionaryValue& job_settings);
 
-  void OnPrintingDone(bool success);
+  void OnPrintingDone(int document_cookie, bool success);
 
   // Enable/Disable window.print calls.  If |blocked| is true window.print
   // calls will silently fail.  Call with |blocked| set to false to reenable.
@@ -273,7 +276,9 @@ class PrintWebViewHelper
 
   // Given the |device| and |canvas| to draw on, prints the appropriate headers
   // and footers using strings from |header_footer_info| on to the canvas.
-  static void PrintHeaderAndFooter(
+  // The page that lays them out is loaded once and kept for the following
+  // pages until CloseHeaderAndFooterView().
+  void PrintHeaderAndFooter(
       WebKit::WebCanvas* canvas,
       int page_number,
       int total_pages,
@@ -282,6 +287,9 @@ class PrintWebViewHelper
       const base::DictionaryValue& header_footer_info,
       const PrintMsg_Print_Params& params);
 
+  // Closes the view PrintHeaderAndFooter() draws with, if it has one.
+  void CloseHeaderAndFooterView();
+
   bool GetPrintFrame(WebKit::WebFrame** frame);
 
   // This reports the current time - |start_time| as the time to render a page.
@@ -347,6 +355,10 @@ class PrintWebViewHelper
   // footers if requested by the user.
   scoped_ptr<base::DictionaryValue> header_footer_info_;
 
+  // Holds the header and footer page between the pages of a print job. It is
+  // closed when printing finishes.
+  WebKit::WebView* header_footer_view_;
+
   // Keeps track of the state of print preview between messages.
   // TODO(vitalybuka): Create PrintPreviewContext when needed and delete after
   // use. Now it's interaction with various messages is confusing.
@@ -412,6 +424,10 @@ class PrintWebViewHelper
     int total_page_count() const;
     bool generate_draft_pages() const;
     PreviewMetafile* metafile();
+    // How long it took to lay out the document and count its pages.
+    base::TimeDelta layout_time() const;
+    // Time spent rendering the pages so far.
+    base::TimeDelta document_render_time() const;
     gfx::Size GetPrintCanvasSize() const;
     int last_error() const;
 
@@ -448,6 +464,7 @@ class PrintWebViewHelper
     // Specifies the total number of pages in the print ready metafile.
     int print_ready_metafile_page_count_;
 
+    base::TimeDelta layout_time_;
     base::TimeDelta document_render_time_;
     base::TimeTicks begin_time_;
 
@@ -20,22 +20,80 @@
 
 #include "content/nw/src/renderer/shell_render_process_observer.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "base/command_line.h"
 #include "base/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/values.h"
 #include "content/public/renderer/render_thread.h"
+#include "content/renderer/v8_value_converter_impl.h"
 #include "content/nw/src/api/api_messages.h"
 #include "content/nw/src/api/dispatcher_bindings.h"
+#include "content/nw/src/common/shell_switches.h"
 #include "webkit/glue/webkit_glue.h"
 #include "webkit/support/gc_extension.h"
 #include "third_party/node/src/node.h"
 #include "third_party/node/src/req_wrap.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebCache.h"
+#include "third_party/WebKit/Source/WebKit/chromium/public/WebFontCache.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebRuntimeFeatures.h"
 #include "v8/include/v8.h"
 
+using WebKit::WebCache;
 using WebKit::WebRuntimeFeatures;
 
 namespace content {
 
+namespace {
+
+// Fill |usage| with the memory held by the WebKit cache and the V8 heap.
+void GetMemoryUsage(base::DictionaryValue* usage) {
+  WebCache::UsageStats stats;
+  WebCache::getUsageStats(&stats);
+  v8::HeapStatistics heap;
+  v8::V8::GetHeapStatistics(&heap);
+
+  double cache_size = static_cast<double>(stats.liveSize + stats.deadSize);
+  double heap_size = static_cast<double>(heap.used_heap_size());
+  usage->SetDouble("webCache", cache_size);
+  usage->SetDouble("v8HeapUsed", heap_size);
+  usage->SetDouble("v8HeapTotal", static_cast<double>(heap.total_heap_size()));
+  usage->SetDouble("total", cache_size + heap_size);
+}
+
+// Returns |capacity| in bytes clamped to what size_t holds, or |current| if
+// |capacity| is negative.
+size_t ToCacheCapacity(int64 capacity, size_t current) {
+  if (capacity < 0)
+    return current;
+  if (static_cast<uint64>(capacity) > std::numeric_limits<size_t>::max())
+    return std::numeric_limits<size_t>::max();
+  return static_cast<size_t>(capacity);
+}
+
+}  // namespace
+
+// static
+void ShellRenderProcessObserver::SetWebCacheCapacities(
+    int64 min_dead_capacity,
+    int64 max_dead_capacity,
+    int64 capacity) {
+  WebCache::UsageStats stats;
+  WebCache::getUsageStats(&stats);
+  size_t min_dead = ToCacheCapacity(min_dead_capacity, stats.minDeadCapacity);
+  size_t max_dead = ToCacheCapacity(max_dead_capacity, stats.maxDeadCapacity);
+  size_t total = ToCacheCapacity(capacity, stats.capacity);
+
+  // WebKit requires min_dead <= max_dead <= capacity.
+  max_dead = std::min(max_dead, total);
+  min_dead = std::min(min_dead, max_dead);
+  WebCache::setCapacities(min_dead, max_dead, total);
+}
+
 ShellRenderProcessObserver::ShellRenderProcessObserver()
   :webkit_initialized_(false) {
   RenderThread::Get()->AddObserver(this);
@@ -50,6 +108,8 @@ bool ShellRenderProcessObserver::OnControlMessageReceived(
   IPC_BEGIN_MESSAGE_MAP(ShellRenderProcessObserver, message)
     IPC_MESSAGE_HANDLER(ShellViewMsg_Open, OnOpen)
     IPC_MESSAGE_HANDLER(ShellViewMsg_ClearCache, OnClearCache)
+    IPC_MESSAGE_HANDLER(ShellViewMsg_App_Event, OnAppEvent)
+    IPC_MESSAGE_HANDLER(ShellViewMsg_PurgeMemory, OnPurgeMemory)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -66,30 +126,83 @@ void ShellRenderProcessObserver::WebKitInitialized() {
   webkit_initialized_ = true;
   RenderThread::Get()->RegisterExtension(new api::DispatcherBindings());
   WebRuntimeFeatures::enableCSSRegions(true);
+
+  CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kWebCacheCapacities)) {
+    std::vector<std::string> values;
+    base::SplitString(
+        command_line->GetSwitchValueASCII(switches::kWebCacheCapacities),
+        ',', &values);
+    int64 capacities[] = { -1, -1, -1 };
+    for (size_t i = 0; i < values.size() && i < arraysize(capacities); ++i)
+      base::StringToInt64(values[i], &capacities[i]);
+    SetWebCacheCapacities(capacities[0], capacities[1], capacities[2]);
+  }
 }
 
 void ShellRenderProcessObserver::OnOpen(const std::string& path) {
+  base::ListValue args;
+  args.AppendString(path);
+  OnAppEvent("open", args);
+}
+
+void ShellRenderProcessObserver::OnClearCache() {
+  if (webkit_initialized_)
+    WebKit::WebCache::clear();
+}
+
+void ShellRenderProcessObserver::OnPurgeMemory(int request_id, bool critical) {
+  if (!webkit_initialized_)
+    return;
+
+  v8::HandleScope handle_scope;
+  base::DictionaryValue* before = new base::DictionaryValue;
+  GetMemoryUsage(before);
+
+  // Drops the memory cache, including the decoded images it holds.
+  WebCache::clear();
+  if (critical) {
+    WebKit::WebFontCache::clear();
+    v8::V8::LowMemoryNotification();
+  } else {
+    v8::V8::IdleNotification();
+  }
+
+  base::DictionaryValue* after = new base::DictionaryValue;
+  GetMemoryUsage(after);
+
+  base::ListValue args;
+  args.AppendInteger(request_id);
+  args.Append(before);
+  args.Append(after);
+  OnAppEvent("memoryPurged", args);
+}
+
+void ShellRenderProcessObserver::OnAppEvent(const std::string& event,
+                                            const base::ListValue& arguments) {
   v8::HandleScope handle_scope;
 
   // the App object is stored in process["_nw_app"].
   v8::Local<v8::Object> process = node::g_context->Global()->Get(
       node::process_symbol)->ToObject();
   v8::Local<v8::String> app_symbol = v8::String::NewSymbol("_nw_app");
-  if (process->Has(app_symbol)) {
-    // process["_nw_app"].emit(path).
-    v8::Local<v8::Object> app = process->Get(app_symbol)->ToObject();
-    v8::Local<v8::Function> emit = v8::Local<v8::Function>::Cast(
-        app->Get(v8::String::New("emit")));
-    v8::Local<v8::Value> argv[] = {
-        v8::String::New("open"), v8::String::New(path.c_str())
-    };
-    emit->Call(app, 2, argv);
-  }
-}
+  if (!process->Has(app_symbol))
+    return;
 
-void ShellRenderProcessObserver::OnClearCache() {
-  if (webkit_initialized_)
-    WebKit::WebCache::clear();
+  // process["_nw_app"].emit(event, arguments...).
+  v8::Local<v8::Object> app = process->Get(app_symbol)->ToObject();
+  v8::Local<v8::Function> emit = v8::Local<v8::Function>::Cast(
+      app->Get(v8::String::New("emit")));
+
+  content::V8ValueConverterImpl converter;
+  std::vector<v8::Handle<v8::Value> > argv;
+  argv.push_back(v8::String::New(event.c_str()));
+  for (size_t i = 0; i < arguments.GetSize(); ++i) {
+    const base::Value* value = NULL;
+    arguments.Get(i, &value);
+    argv.push_back(converter.ToV8Value(value, node::g_context));
+  }
+  emit->Call(app, argv.size(), &argv[0]);
 }
 
 }  // namespace content
@@ -27,6 +27,10 @@
 #include "base/compiler_specific.h"
 #include "content/public/renderer/render_process_observer.h"
 
+namespace base {
+class ListValue;
+}
+
 namespace content {
 
 class ShellRenderProcessObserver : public RenderProcessObserver {
@@ -38,9 +42,18 @@ class ShellRenderProcessObserver : public RenderProcessObserver {
   virtual bool OnControlMessageReceived(const IPC::Message& message) OVERRIDE;
   virtual void OnRenderProcessWillShutdown() OVERRIDE;
   virtual void WebKitInitialized() OVERRIDE;
+
+  // Set the capacities of WebKit's memory cache in bytes. A negative value
+  // keeps the current value for that capacity.
+  static void SetWebCacheCapacities(int64 min_dead_capacity,
+                                    int64 max_dead_capacity,
+                                    int64 capacity);
+
  private:
   void OnOpen(const std::string& path);
   void OnClearCache();
+  void OnAppEvent(const std::string& event, const base::ListValue& arguments);
+  void OnPurgeMemory(int request_id, bool critical);
 
   bool webkit_initialized_;
 
@@ -43,6 +43,14 @@
 #endif
 
 namespace content {
+
+namespace {
+
+// How often the "memory" cookie store writes its snapshot by default.
+const int kDefaultCookieSnapshotIntervalSeconds = 30;
+
+}  // namespace
+
 class ShellBrowserContext::ShellResourceContext : public ResourceContext {
  public:
   ShellResourceContext() : getter_(NULL) {}
@@ -149,12 +157,25 @@ net::URLRequestContextGetter* ShellBrowserContext::GetRequestContext()  {
 net::URLRequestContextGetter* ShellBrowserContext::CreateRequestContext(
     ProtocolHandlerMap* protocol_handlers) {
   DCHECK(!url_request_getter_);
+
+  std::string cookie_store;
+  bool snapshot_cookies =
+      package_->root()->GetString(switches::kmCookieStore, &cookie_store) &&
+      cookie_store == "memory";
+  int snapshot_interval = kDefaultCookieSnapshotIntervalSeconds;
+  package_->root()->GetInteger(switches::kmCookieSnapshotInterval,
+                               &snapshot_interval);
+  if (snapshot_interval <= 0)
+    snapshot_interval = kDefaultCookieSnapshotIntervalSeconds;
+
   url_request_getter_ = new ShellURLRequestContextGetter(
       ignore_certificate_errors_,
       GetPath(),
       BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::IO),
       BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::FILE),
-      protocol_handlers);
+      protocol_handlers,
+      snapshot_cookies,
+      base::TimeDelta::FromSeconds(snapshot_interval));
   resource_context_->set_url_request_context_getter(url_request_getter_.get());
   return url_request_getter_.get();
 }
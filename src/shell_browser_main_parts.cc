@@ -30,6 +30,7 @@
 #include "chrome/common/chrome_switches.h"
 #include "content/nw/src/api/app/app.h"
 #include "content/nw/src/api/dispatcher_host.h"
+#include "content/nw/src/browser/memory_pressure_monitor.h"
 #include "content/nw/src/browser/printing/print_job_manager.h"
 #include "content/nw/src/browser/shell_devtools_delegate.h"
 #include "content/nw/src/common/shell_switches.h"
@@ -140,6 +141,8 @@ void ShellBrowserMainParts::PostMainMessageLoopRun() {
   if (notify_result_ == ProcessSingleton::PROCESS_NONE)
     process_singleton_->Cleanup();
 
+  memory_pressure_monitor_.reset();
+  memory_pressure_listener_.reset();
   browser_context_.reset();
   off_the_record_browser_context_.reset();
 }
@@ -193,6 +196,12 @@ void ShellBrowserMainParts::Init() {
   }
   devtools_delegate_ = new ShellDevToolsDelegate(browser_context_.get(), port);
 
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&ShellBrowserMainParts::OnMemoryPressure,
+                 base::Unretained(this))));
+  // Base only hears about memory pressure from the system on Android.
+  memory_pressure_monitor_.reset(new nw::MemoryPressureMonitor());
+
   Shell::Create(browser_context_.get(),
                 package()->GetStartupURL(),
                 NULL,
@@ -200,6 +209,14 @@ void ShellBrowserMainParts::Init() {
                 NULL);
 }
 
+void ShellBrowserMainParts::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  api::App::PurgeMemory(
+      NULL, 0,
+      memory_pressure_level ==
+          base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+}
+
 bool ShellBrowserMainParts::ProcessSingletonNotificationCallback(
     const CommandLine& command_line,
     const base::FilePath& current_directory) {
@@ -7,6 +7,7 @@
 
 #include "base/memory/ref_counted_memory.h"
 #include "base/basictypes.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
 #include "chrome/browser/process_singleton.h"
 #include "content/public/browser/browser_main_parts.h"
@@ -17,6 +18,7 @@ class Thread;
 }
 
 namespace nw {
+class MemoryPressureMonitor;
 class Package;
 }
 
@@ -60,6 +62,10 @@ class ShellBrowserMainParts : public BrowserMainParts {
   virtual printing::PrintJobManager* print_job_manager();
 
  private:
+  // Purge the renderers' caches when the OS reports memory pressure.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   bool ProcessSingletonNotificationCallback(const CommandLine& command_line,
                                             const base::FilePath& current_directory);
 
@@ -69,6 +75,9 @@ class ShellBrowserMainParts : public BrowserMainParts {
 
   scoped_ptr<ProcessSingleton> process_singleton_;
 
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  scoped_ptr<nw::MemoryPressureMonitor> memory_pressure_monitor_;
+
   // Ensures that all the print jobs are finished before closing the browser.
   scoped_ptr<printing::PrintJobManager> print_job_manager_;
 
@@ -27,6 +27,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/values.h"
+#include "cc/switches.h"
 #include "content/browser/child_process_security_policy_impl.h"
 #include "content/public/browser/browser_url_handler.h"
 #include "content/nw/src/browser/printing/printing_message_filter.h"
@@ -38,6 +39,7 @@
 #include "content/public/common/renderer_preferences.h"
 #include "content/public/common/url_constants.h"
 #include "content/nw/src/api/dispatcher_host.h"
+#include "content/nw/src/browser/native_window.h"
 #include "content/nw/src/common/shell_switches.h"
 #include "content/nw/src/browser/printing/print_job_manager.h"
 #include "content/nw/src/browser/shell_devtools_delegate.h"
@@ -104,6 +106,39 @@ void ShellContentBrowserClient::AppendExtraCommandLineSwitches(
     int child_process_id) {
   if (command_line->GetSwitchValueASCII("type") != "renderer")
     return;
+
+  // Impl-side painting and the raster thread count may come from the
+  // manifest, which content does not know to forward.
+  static const char* const kRasterSwitches[] = {
+    cc::switches::kEnableImplSidePainting,
+    cc::switches::kNumRasterThreads,
+  };
+  command_line->CopySwitchesFrom(*CommandLine::ForCurrentProcess(),
+                                 kRasterSwitches,
+                                 arraysize(kRasterSwitches));
+
+  // The cache capacities go to every renderer, including those that get no
+  // Node below.
+  nw::Package* package = shell_browser_main_parts()->package();
+  base::DictionaryValue* webcache;
+  if (package && package->root()->GetDictionary(switches::kmWebCache,
+                                                &webcache)) {
+    // -1 keeps WebKit's default for that capacity.
+    int64 capacities[] = { -1, -1, -1 };
+    const char* keys[] = { switches::kmMinDeadCapacity,
+                           switches::kmMaxDeadCapacity,
+                           switches::kmCapacity };
+    std::vector<std::string> values;
+    for (size_t i = 0; i < arraysize(keys); ++i) {
+      int mb;
+      if (webcache->GetInteger(keys[i], &mb) && mb >= 0)
+        capacities[i] = static_cast<int64>(mb) * 1024 * 1024;
+      values.push_back(base::Int64ToString(capacities[i]));
+    }
+    command_line->AppendSwitchASCII(switches::kWebCacheCapacities,
+                                    JoinString(values, ','));
+  }
+
   if (child_process_id > 0) {
     content::RenderProcessHost* rph =
       content::RenderProcessHost::FromID(child_process_id);
@@ -131,7 +166,6 @@ void ShellContentBrowserClient::AppendExtraCommandLineSwitches(
       }
     }
   }
-  nw::Package* package = shell_browser_main_parts()->package();
   if (package && package->GetUseNode()) {
     // Allow node.js
     command_line->AppendSwitch(switches::kNodejs);
@@ -219,6 +253,14 @@ void ShellContentBrowserClient::OverrideWebkitPrefs(
   prefs->plugins_enabled = false;
   prefs->java_enabled = false;
 
+  // A window made headless by its own manifest shares the GPU settings of
+  // the app, so keep at least its page out of the GPU compositor.
+  Shell* shell = Shell::FromRenderViewHost(render_view_host);
+  if (shell && shell->window() && shell->window()->IsHeadless()) {
+    prefs->accelerated_compositing_enabled = false;
+    prefs->accelerated_2d_canvas_enabled = false;
+  }
+
   base::DictionaryValue* webkit;
   if (package->root()->GetDictionary(switches::kmWebkit, &webkit)) {
     webkit->GetBoolean(switches::kmJava, &prefs->java_enabled);
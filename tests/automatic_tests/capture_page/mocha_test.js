@@ -0,0 +1,252 @@
+var gui = require('nw.gui');
+var assert = require('assert');
+
+describe('Window.capturePage', function() {
+  var win = gui.Window.get();
+
+  it('should default to jpeg', function(done) {
+    this.timeout(5000);
+    win.capturePage(function(img) {
+      assert.equal(img.indexOf('data:image/jpeg;base64,'), 0);
+      done();
+    });
+  })
+
+  it('should accept the old format argument', function(done) {
+    this.timeout(5000);
+    win.capturePage(function(img) {
+      assert.equal(img.indexOf('data:image/png;base64,'), 0);
+      done();
+    }, 'png');
+  })
+
+  it('should encode png with a compression level', function(done) {
+    this.timeout(5000);
+    win.capturePage(function(img) {
+      var data = new Buffer(img.split(',')[1], 'base64');
+      assert.equal(data.toString('ascii', 1, 4), 'PNG');
+      done();
+    }, { format: 'png', compression: 1 });
+  })
+
+  it('should encode jpeg with a quality', function(done) {
+    this.timeout(5000);
+    win.capturePage(function(img) {
+      assert.equal(img.indexOf('data:image/jpeg;base64,'), 0);
+      done();
+    }, { format: 'jpeg', quality: 30 });
+  })
+
+  it('should encode webp', function(done) {
+    this.timeout(5000);
+    win.capturePage(function(data) {
+      assert.equal(data.toString('ascii', 0, 4), 'RIFF');
+      assert.equal(data.toString('ascii', 8, 12), 'WEBP');
+      done();
+    }, { format: 'webp', quality: 50, datatype: 'buffer' });
+  })
+
+  it('should scale to the given width', function(done) {
+    this.timeout(5000);
+    win.capturePage(function(data) {
+      // Width and height of the IHDR chunk.
+      assert.equal(data.readUInt32BE(16), 100);
+      assert.equal(data.readUInt32BE(20),
+                   Math.max(1, Math.round(100 * window.innerHeight /
+                                          window.innerWidth)));
+      done();
+    }, { format: 'png', width: 100, datatype: 'buffer' });
+  })
+
+  it('should hand concurrent captures their own results', function(done) {
+    this.timeout(5000);
+    // The slow PNG is asked for first but the JPEG is encoded first.
+    var left = 2;
+    win.capturePage(function(img) {
+      assert.equal(img.indexOf('data:image/png;base64,'), 0);
+      if (--left == 0)
+        done();
+    }, { format: 'png', compression: 9 });
+    win.capturePage(function(img) {
+      assert.equal(img.indexOf('data:image/jpeg;base64,'), 0);
+      if (--left == 0)
+        done();
+    }, { format: 'jpeg', width: 10 });
+  })
+})
+
+describe('Window.capturePage datatype', function() {
+  var win = gui.Window.get();
+
+  it('should return a Buffer', function(done) {
+    this.timeout(5000);
+    win.capturePage(function(data) {
+      assert(Buffer.isBuffer(data));
+      assert.equal(data.toString('ascii', 1, 4), 'PNG');
+      done();
+    }, { format: 'png', datatype: 'buffer' });
+  })
+
+  it('should write to a file', function(done) {
+    this.timeout(5000);
+    var fs = require('fs');
+    var path = require('path');
+    var file = path.join(require('os').tmpDir(), 'nw_capture_page.jpg');
+    win.capturePage(function(result) {
+      assert.equal(result, file);
+      assert(fs.statSync(file).size > 0);
+      fs.unlinkSync(file);
+      done();
+    }, { datatype: 'file', path: file });
+  })
+})
+
+describe('Window.capturePage fullPage', function() {
+  var win = gui.Window.get();
+  var spacer;
+
+  before(function() {
+    spacer = document.createElement('div');
+    spacer.style.height = '5000px';
+    document.body.appendChild(spacer);
+  })
+
+  after(function() {
+    document.body.removeChild(spacer);
+  })
+
+  it('should stitch the whole page into one png', function(done) {
+    this.timeout(10000);
+    win.capturePage(function(data) {
+      assert.equal(data.toString('ascii', 1, 4), 'PNG');
+      // The IHDR height is the page height, not the window height.
+      assert(data.readUInt32BE(20) >= 5000);
+      done();
+    }, { fullPage: true, datatype: 'buffer' });
+  })
+
+  it('should deliver tiles in page order', function(done) {
+    this.timeout(10000);
+    var next = 0;
+    win.capturePage(function(img, tile) {
+      assert.equal(tile.index, next++);
+      assert(tile.height <= 512);
+      assert.equal(img.indexOf('data:image/jpeg;base64,'), 0);
+      if (tile.last) {
+        assert(next >= 10);
+        done();
+      }
+    }, { fullPage: true, tiled: true, tileHeight: 512 });
+  })
+
+  it('should keep the window size and scroll position', function(done) {
+    this.timeout(10000);
+    window.scrollTo(0, 1000);
+    var height = window.innerHeight;
+    win.capturePage(function(img, tile) {
+      assert.equal(window.innerHeight, height);
+      assert.equal(window.scrollY, 1000);
+      if (tile.last) {
+        window.scrollTo(0, 0);
+        done();
+      }
+    }, { fullPage: true, tiled: true, tileHeight: 1024 });
+  })
+
+  it('should not mix up a full page and a window capture', function(done) {
+    this.timeout(10000);
+    var left = 2;
+    win.capturePage(function(data) {
+      assert(data.readUInt32BE(20) >= 5000);
+      if (--left == 0)
+        done();
+    }, { fullPage: true, datatype: 'buffer' });
+    win.capturePage(function(data) {
+      assert.equal(data.readUInt32BE(20), 10);
+      if (--left == 0)
+        done();
+    }, { format: 'png', height: 10, datatype: 'buffer' });
+  })
+
+  it('should call back with an error if the capture fails', function(done) {
+    this.timeout(10000);
+    win.capturePage(function(data, err) {
+      assert.equal(data, null);
+      assert(err instanceof Error);
+      done();
+    }, { fullPage: true, datatype: 'file',
+         path: '/nonexistent-dir/nw-capture.png' });
+  })
+})
+
+describe('Window.startScreencast', function() {
+  var win = gui.Window.get();
+
+  afterEach(function() {
+    win.stopScreencast();
+  })
+
+  it('should start with a keyframe covering the window', function(done) {
+    this.timeout(5000);
+    win.startScreencast({ maxFps: 5 }, function(frame) {
+      win.stopScreencast();
+      assert(frame.keyframe);
+      assert.equal(frame.rects.length, 1);
+      assert.equal(frame.rects[0].width, frame.width);
+      assert.equal(frame.rects[0].data.indexOf('data:image/jpeg;base64,'), 0);
+      done();
+    });
+  })
+
+  it('should only send the changed area after a paint', function(done) {
+    this.timeout(5000);
+    var box = document.createElement('div');
+    box.style.cssText = 'position:absolute;left:0;top:0;width:40px;' +
+                        'height:40px;background:red';
+    win.startScreencast({ format: 'png' }, function(frame) {
+      if (frame.keyframe) {
+        document.body.appendChild(box);
+        return;
+      }
+      win.stopScreencast();
+      document.body.removeChild(box);
+      assert(frame.rects.length >= 1);
+      assert(frame.rects[0].width < frame.width);
+      done();
+    });
+  })
+})
+
+describe('App.captureAllWindows', function() {
+  var win = gui.Window.get();
+
+  it('should capture every window', function(done) {
+    this.timeout(10000);
+    var other = gui.Window.open('about:blank', { show: false });
+    other.on('loaded', function() {
+      gui.App.captureAllWindows({ format: 'png' }, function(windows) {
+        other.close(true);
+        assert(windows.length >= 2);
+        var self = windows.filter(function(w) { return w.id == win.id; });
+        assert.equal(self.length, 1);
+        assert.equal(self[0].data.indexOf('data:image/png;base64,'), 0);
+        done();
+      });
+    });
+  })
+
+  it('should not wait for hidden windows', function(done) {
+    // Well below the 10 s the capture waits for windows that paint.
+    this.timeout(3000);
+    var other = gui.Window.open('about:blank', { show: false });
+    other.on('loaded', function() {
+      gui.App.captureAllWindows(function(windows) {
+        other.close(true);
+        var hidden = windows.filter(function(w) { return w.id == other.id; });
+        assert.equal(hidden.length, 1);
+        assert.equal(hidden[0].data, null);
+        done();
+      });
+    });
+  })
+})
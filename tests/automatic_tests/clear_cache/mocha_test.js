@@ -0,0 +1,18 @@
+var gui = require('nw.gui');
+var assert = require('assert');
+
+describe('App.clearCache', function() {
+  it('should call back when the cache is cleared', function(done) {
+    gui.App.clearCache(function() {
+      done();
+    });
+  })
+
+  it('should accept a time range', function(done) {
+    gui.App.clearCache({ since: Date.now() - 60 * 1000 }, done);
+  })
+
+  it('should accept a list of origins', function(done) {
+    gui.App.clearCache({ origins: [ 'http://localhost' ] }, done);
+  })
+})
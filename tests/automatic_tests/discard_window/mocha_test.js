@@ -0,0 +1,68 @@
+var gui = require('nw.gui');
+var assert = require('assert');
+
+describe('Window.discard', function() {
+  var win;
+
+  beforeEach(function(done) {
+    win = gui.Window.open(global.tests_dir + '/discard_window/page.html',
+                          { show: false });
+    win.once('loaded', function() { done(); });
+  })
+
+  afterEach(function() {
+    win.close(true);
+  })
+
+  it('should discard a hidden window and revive it on show', function(done) {
+    this.timeout(10000);
+    var discarded = false;
+    win.once('discard', function() { discarded = true; });
+    win.once('revive', function() {
+      assert(discarded);
+      assert(!win.isDiscarded);
+      done();
+    });
+    win.hide();
+    win.discard();
+    setTimeout(function() {
+      assert(win.isDiscarded);
+      win.show();
+    }, 1000);
+  })
+
+  it('should keep the history, scroll position and form', function(done) {
+    this.timeout(10000);
+    var page = win.window;
+    page.location.hash = '#second';
+    page.scrollTo(0, 1500);
+    page.document.getElementById('name').value = 'kept';
+    var historyLength = page.history.length;
+
+    win.once('revive', function() {
+      // The page is a new document; look it up again.
+      var revived = win.window;
+      assert.equal(revived.location.hash, '#second');
+      assert.equal(revived.history.length, historyLength);
+      assert.equal(revived.scrollY, 1500);
+      assert.equal(revived.document.getElementById('name').value, 'kept');
+      done();
+    });
+    win.hide();
+    win.discard();
+    setTimeout(function() {
+      assert(win.isDiscarded);
+      win.show();
+    }, 1000);
+  })
+
+  it('should not discard a visible window', function(done) {
+    this.timeout(5000);
+    win.show();
+    win.discard();
+    setTimeout(function() {
+      assert(!win.isDiscarded);
+      done();
+    }, 500);
+  })
+})
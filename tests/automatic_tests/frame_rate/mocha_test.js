@@ -0,0 +1,65 @@
+var gui = require('nw.gui');
+var assert = require('assert');
+
+describe('Window.setMaxFps', function() {
+  var win = gui.Window.get();
+
+  afterEach(function() {
+    win.setMaxFps(0);
+  })
+
+  function countFrames(duration, callback) {
+    var frames = 0;
+    var start = Date.now();
+    var tick = function() {
+      if (Date.now() - start >= duration)
+        return callback(frames * 1000 / duration);
+      ++frames;
+      window.requestAnimationFrame(tick);
+    };
+    window.requestAnimationFrame(tick);
+  }
+
+  it('should leave the page alone until a cap is set', function(done) {
+    this.timeout(5000);
+    var native = /\[native code\]/;
+    assert(native.test(String(window.requestAnimationFrame)));
+    var names = Object.getOwnPropertyNames(window).sort().join();
+    win.setMaxFps(10);
+    setTimeout(function() {
+      // Only the wrapped functions change; no global is added.
+      assert(!native.test(String(window.requestAnimationFrame)));
+      assert.equal(Object.getOwnPropertyNames(window).sort().join(), names);
+      done();
+    }, 200);
+  })
+
+  it('should cap requestAnimationFrame', function(done) {
+    this.timeout(5000);
+    win.setMaxFps(10);
+    // The cap reaches the renderer asynchronously.
+    setTimeout(function() {
+      countFrames(2000, function(fps) {
+        assert(fps <= 11, 'got ' + fps + ' fps');
+        assert(fps >= 5, 'got ' + fps + ' fps');
+        done();
+      });
+    }, 200);
+  })
+
+  it('should cancel a held back frame', function(done) {
+    this.timeout(5000);
+    win.setMaxFps(2);
+    setTimeout(function() {
+      window.requestAnimationFrame(function() {
+        var called = false;
+        var id = window.requestAnimationFrame(function() { called = true; });
+        window.cancelAnimationFrame(id);
+        setTimeout(function() {
+          assert(!called);
+          done();
+        }, 1000);
+      });
+    }, 200);
+  })
+})
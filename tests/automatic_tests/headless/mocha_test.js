@@ -0,0 +1,30 @@
+var path = require('path');
+var assert = require('assert');
+var app_test = require('./nw_test_app');
+
+describe('headless', function() {
+  it('should render and capture without a native window', function(done) {
+    this.timeout(0);
+    var result = false;
+
+    var child = app_test.createChildProcess({
+      execPath: process.execPath,
+      appPath: path.join(global.tests_dir, 'headless'),
+      end: function(data, app) {
+        result = true;
+        app.kill();
+        assert(data.png);
+        assert.equal(data.width, 640);
+        assert.equal(data.height, 480);
+        done();
+      }
+    });
+
+    setTimeout(function() {
+      if (!result) {
+        child.close();
+        done('headless app did not report a capture');
+      }
+    }, 5000);
+  })
+})
@@ -0,0 +1,79 @@
+var gui = require('nw.gui');
+var assert = require('assert');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+
+describe('Window.printToPDF', function() {
+  var win = gui.Window.get();
+
+  it('should return a Buffer', function(done) {
+    this.timeout(10000);
+    win.printToPDF(function(err, data, info) {
+      assert.equal(err, null);
+      assert(Buffer.isBuffer(data));
+      assert.equal(data.toString('ascii', 0, 4), '%PDF');
+      assert(info.pages >= 1);
+      done();
+    });
+  })
+
+  it('should write to a file', function(done) {
+    this.timeout(10000);
+    var file = path.join(os.tmpDir(), 'nw_print_to_pdf.pdf');
+    win.printToPDF({ path: file, pageSize: 'A4', landscape: true },
+                   function(err, data, info) {
+      assert.equal(err, null);
+      assert.equal(data, file);
+      assert.equal(fs.readFileSync(file).toString('ascii', 0, 4), '%PDF');
+      var phases = [ 'layout', 'render', 'finalize', 'ipc', 'write' ];
+      phases.forEach(function(phase) {
+        assert(info.timing[phase] >= 0, phase);
+      });
+      fs.unlinkSync(file);
+      done();
+    });
+  })
+
+  it('should print the given page range', function(done) {
+    this.timeout(10000);
+    var page = '<div style="page-break-after: always">page</div>';
+    var pdfWin = gui.Window.open(
+        'data:text/html,' + new Array(6).join(page), { show: false });
+    pdfWin.once('loaded', function() {
+      pdfWin.printToPDF({ pageRanges: [ { from: 2, to: 3 } ] },
+                        function(err, data, info) {
+        pdfWin.close(true);
+        assert.equal(err, null);
+        assert.equal(info.pages, 2);
+        done();
+      });
+    });
+  })
+
+  it('should reject an unknown page size', function() {
+    assert.throws(function() {
+      win.printToPDF({ pageSize: 'B52' });
+    }, TypeError);
+  })
+
+  it('should print a long document quickly', function(done) {
+    this.timeout(60000);
+    var page = '<div style="page-break-after: always">' +
+               new Array(200).join('Lorem ipsum dolor sit amet. ') + '</div>';
+    var pdfWin = gui.Window.open(
+        'data:text/html,' + new Array(51).join(page), { show: false });
+    pdfWin.once('loaded', function() {
+      pdfWin.printToPDF(function(err, data, info) {
+        pdfWin.close(true);
+        assert.equal(err, null);
+        assert(info.pages >= 50);
+        console.log('printToPDF: ' + info.pages + ' pages in ' +
+                    Math.round(info.elapsed) + ' ms, ' +
+                    (info.pages * 1000 / info.elapsed).toFixed(1) +
+                    ' pages/sec');
+        done();
+      });
+    });
+  })
+})
@@ -0,0 +1,21 @@
+var gui = require('nw.gui');
+var assert = require('assert');
+
+describe('App.purgeMemory', function() {
+  it('should report memory usage before and after', function(done) {
+    gui.App.purgeMemory(function(before, after) {
+      assert.equal(typeof before.total, 'number');
+      assert.equal(typeof after.total, 'number');
+      // Resources still in use by the page stay in the cache.
+      assert(after.webCache <= before.webCache);
+      done();
+    });
+  })
+
+  it('should accept the critical level', function(done) {
+    gui.App.purgeMemory('critical', function(before, after) {
+      assert(after.v8HeapUsed <= before.v8HeapUsed);
+      done();
+    });
+  })
+})
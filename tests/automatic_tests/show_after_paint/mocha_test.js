@@ -0,0 +1,36 @@
+var gui = require('nw.gui');
+var assert = require('assert');
+
+describe('show-after-paint', function() {
+  var win;
+
+  afterEach(function() {
+    win.close(true);
+  })
+
+  it('should show the window after its first paint', function(done) {
+    this.timeout(10000);
+    win = gui.Window.open('data:text/html,<p>painted</p>', {
+      show: true,
+      'show-after-paint': true
+    });
+    win.once('first-paint', function(timing) {
+      assert(timing.firstPaint >= 0);
+      assert(timing.shown >= 0);
+      assert.equal(timing.timedOut, false);
+      done();
+    });
+  })
+
+  it('should report the timing of windows shown right away', function(done) {
+    this.timeout(10000);
+    win = gui.Window.open('data:text/html,<p>painted</p>', { show: true });
+    win.once('first-paint', function() {
+      var timing = win.paintTiming;
+      assert(timing.firstPaint >= 0);
+      assert(timing.shown >= 0);
+      assert(timing.shown <= timing.firstPaint);
+      done();
+    });
+  })
+})
@@ -0,0 +1,34 @@
+var gui = require('nw.gui');
+var assert = require('assert');
+
+describe('App.setCacheCapacities', function() {
+  var original = gui.App.getCacheUsage();
+
+  after(function() {
+    gui.App.setCacheCapacities(original);
+  })
+
+  it('getCacheUsage should report capacities and sizes', function() {
+    var usage = gui.App.getCacheUsage();
+    assert.equal(typeof usage.capacity, 'number');
+    assert.equal(typeof usage.liveSize, 'number');
+    assert.equal(typeof usage.deadSize, 'number');
+  })
+
+  it('should change the capacities', function() {
+    gui.App.setCacheCapacities({ minDeadCapacity: 0,
+                                 maxDeadCapacity: 1024 * 1024,
+                                 capacity: 4 * 1024 * 1024 });
+    var usage = gui.App.getCacheUsage();
+    assert.equal(usage.minDeadCapacity, 0);
+    assert.equal(usage.maxDeadCapacity, 1024 * 1024);
+    assert.equal(usage.capacity, 4 * 1024 * 1024);
+  })
+
+  it('should keep capacities that are not given', function() {
+    gui.App.setCacheCapacities({ capacity: 8 * 1024 * 1024 });
+    var usage = gui.App.getCacheUsage();
+    assert.equal(usage.maxDeadCapacity, 1024 * 1024);
+    assert.equal(usage.capacity, 8 * 1024 * 1024);
+  })
+})